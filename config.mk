@@ -3,7 +3,9 @@ INCLUDE = ./include
 LIB     = ./lib
 SRC     = ./src
 BIN     = ./bin
+TEST    = ./test
 
 # Compiler and link
-COMPILER = g++ -O3 --std=c++0x -funroll-loops
+COMPILER = g++ -O3 --std=c++0x -funroll-loops -pthread
+C_COMPILER = gcc -O2 -std=c99
 LINKER   = g++ -O2 
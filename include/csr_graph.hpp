@@ -0,0 +1,104 @@
+#ifndef _MY_CSR_GRAPH_
+#define _MY_CSR_GRAPH_
+
+/// For short integers
+#include <stdint.h>
+#include <cstddef>
+
+#include <vector>
+using std::vector;
+
+#include <utility>
+using std::pair;
+
+#include "graph_alloc.hpp"
+
+typedef pair<uint32_t,uint32_t>  CsrEdge;
+typedef vector<CsrEdge>          CsrEdgeList;
+
+///------------------------------------------------------------------------------------------
+/// Sparse binary graph format (.csr)
+///
+///   CsrHeader                          64 bytes
+///   uint64_t offsets[n+1]              start of the neighbors of each vertex
+///   neighbor section                   adjBytes bytes
+///
+/// Every undirected edge is stored in both directions, neighbors are sorted.
+/// If CSR_VARINT is set, the neighbors of a vertex are gap encoded as LEB128
+/// varints (first value absolute) and offsets are byte offsets into the section;
+/// otherwise the section is a plain uint32_t array and offsets are array indices.
+/// The checksum is a FNV-1a hash over the offsets and the neighbor section.
+#define CSR_MAGIC    "RLFCSR\n"
+#define CSR_VERSION  1
+#define CSR_VARINT   1U
+
+struct CsrHeader {
+  char     magic[8];     /// CSR_MAGIC, zero terminated
+  uint32_t version;      /// CSR_VERSION
+  uint32_t flags;        /// CSR_VARINT
+  uint64_t n;            /// Number of vertices
+  uint64_t m;            /// Number of (undirected) edges
+  uint64_t adjBytes;     /// Size in bytes of the neighbor section
+  uint64_t checksum;     /// FNV-1a over offsets and neighbor section
+  uint64_t reserved[2];
+};
+
+///------------------------------------------------------------------------------------------
+/// Compressed sparse row graph:
+/// the neighbors of v are adj[off[v]] ... adj[off[v+1]-1], sorted
+class CsrGraph {
+public:
+  CsrGraph ( void ) : n(0), m(0), off(NULL), adj(NULL), map(NULL), mapLen(0) {}
+  ~CsrGraph ();
+
+  uint32_t        n;    /// Number of vertices
+  uint64_t        m;    /// Number of (undirected) edges
+  const uint64_t* off;  /// Offsets, n+1 entries
+  const uint32_t* adj;  /// Neighbors, 2m entries
+
+  /// Get the vertex degree
+  inline uint32_t degree ( uint32_t v ) const { return uint32_t(off[v+1]-off[v]); }
+
+  /// Storage owned by the graph (the pointers above refer to it)
+  GraphVector<uint64_t> offsets;
+  GraphVector<uint32_t> neighbors;
+
+  /// Let 'off' and 'adj' point to the owned storage
+  void attach ( void );
+
+  /// Copy a memory mapped file into the owned storage and unmap it, so that
+  /// the graph no longer depends on the file (a truncated file would fault)
+  void own ( void );
+
+  /// Memory mapped file (raw .csr files are used in place)
+  void*  map;
+  size_t mapLen;
+
+private:
+  /// The pointers refer to the owned storage: no copies
+  CsrGraph ( const CsrGraph& );
+  CsrGraph& operator= ( const CsrGraph& );
+};
+
+/// Build the graph from an edge list over vertices 0..n-1.
+/// Self loops and duplicated edges are dropped, 'edges' is cleared.
+void csr_from_edges ( CsrGraph& g, uint32_t n, CsrEdgeList& edges );
+
+/// Write the graph in the sparse binary format; return false on I/O error
+bool write_csr_bin ( const CsrGraph& g, const char* name, bool varint );
+
+/// Open a sparse binary file. Raw files are memory mapped and used in place,
+/// varint files are decoded. The structure is always checked (offsets from 0,
+/// never decreasing, within the file; 2m entries; every list strictly
+/// increasing, below n, without its own vertex and every edge listed from
+/// both ends); if 'verify' is set, the checksum is checked too.
+/// Return false (and print the reason) if the file is not valid.
+bool read_csr_bin ( CsrGraph& g, const char* name, bool verify );
+
+/// Return true if the file starts with the CSR_MAGIC string
+bool is_csr_bin ( const char* name );
+
+/// FNV-1a hash, chained through 'h'
+uint64_t csr_checksum ( const void* data, size_t len, uint64_t h );
+
+#endif
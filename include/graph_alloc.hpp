@@ -0,0 +1,73 @@
+#ifndef _MY_GRAPH_ALLOC_
+#define _MY_GRAPH_ALLOC_
+
+#include <stdint.h>
+#include <cstddef>
+#include <new>
+
+#include <vector>
+using std::vector;
+
+///------------------------------------------------------------------------------------------
+/// Allocation of the graph storage (CSR arrays and engine arrays).
+///
+/// By default the arrays come from operator new. With PAGES_HUGE, every array
+/// of at least 2 MB gets its own mapping aligned to 2 MB and advised for
+/// transparent huge pages (madvise); with NUMA_INTERLEAVE the mapping is
+/// interleaved over the online nodes (mbind). Otherwise pages are placed on
+/// the node of the thread that first touches them: the engines allocate and
+/// fill their arrays in the thread that runs them.
+///
+/// The huge pages actually obtained by the live mappings are read back from
+/// /proc/self/smaps when the stats are asked; releasing a mapping costs no
+/// more than the munmap.
+enum GraphPages { PAGES_DEFAULT = 0, PAGES_HUGE, NUM_PAGES };
+enum GraphNuma  { NUMA_LOCAL = 0, NUMA_INTERLEAVE, NUM_NUMA };
+
+/// Policy by name ("default", "huge"; "local", "interleave"); NUM_* if unknown
+GraphPages  pages_from_name ( const char* s );
+GraphNuma   numa_from_name  ( const char* s );
+
+/// Set the policy of the next allocations (call before building the graphs)
+void graph_memory_policy ( GraphPages pages, GraphNuma numa );
+
+/// Mappings made under the policy, live or released
+struct GraphMemStats {
+  size_t      regions;      /// Mappings
+  size_t      bytes;        /// Bytes mapped
+  size_t      hugeBytes;    /// Bytes of the live mappings backed by huge pages
+  size_t      interleaved;  /// Mappings interleaved over the nodes
+  unsigned    nodes;        /// Online NUMA nodes
+  const char* thp;          /// Kernel THP mode ("always", "madvise", "never", "unknown")
+};
+void graph_memory_stats ( GraphMemStats& s );
+
+/// Raw allocation under the policy (operator new below 2 MB or without policy)
+void* graph_alloc ( size_t bytes );
+void  graph_free  ( void* p, size_t bytes );
+
+/// Standard allocator over graph_alloc
+template <class T>
+class GraphAllocator {
+public:
+  typedef T value_type;
+
+  GraphAllocator ( void ) {}
+  template <class U> GraphAllocator ( const GraphAllocator<U>& ) {}
+
+  T* allocate ( size_t n ) {
+    return static_cast<T*>( graph_alloc( n * sizeof(T) ) );
+  }
+  void deallocate ( T* p, size_t n ) {
+    graph_free( p, n * sizeof(T) );
+  }
+
+  template <class U> bool operator== ( const GraphAllocator<U>& ) const { return true;  }
+  template <class U> bool operator!= ( const GraphAllocator<U>& ) const { return false; }
+};
+
+/// Vector of graph storage
+template <class T>
+using GraphVector = vector< T, GraphAllocator<T> >;
+
+#endif
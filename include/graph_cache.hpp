@@ -0,0 +1,68 @@
+#ifndef _MY_GRAPH_CACHE_
+#define _MY_GRAPH_CACHE_
+
+#include <sys/types.h>
+#include <ctime>
+
+#include <string>
+using std::string;
+
+#include <list>
+using std::list;
+
+#include <map>
+using std::map;
+
+#include <memory>
+using std::shared_ptr;
+
+#include <mutex>
+using std::mutex;
+
+#include "csr_graph.hpp"
+
+/// Memory used by a loaded graph
+size_t csr_bytes ( const CsrGraph& g );
+
+///------------------------------------------------------------------------------------------
+/// LRU cache of loaded graphs, keyed by file path.
+/// An entry is valid as long as the file keeps its modification time and size:
+/// a changed file is loaded again. Graphs are shared, read only, by the runs
+/// that use them and are released when the last run ends, even if evicted.
+/// Raw .csr files are copied rather than used in place, so a file changed on
+/// disk never affects a loaded graph.
+class GraphCache {
+public:
+  /// Keep at most 'maxGraphs' graphs and 'maxBytes' bytes (0 = no limit)
+  GraphCache ( size_t maxGraphs, size_t maxBytes );
+
+  /// Return the graph stored in 'name', NULL if it cannot be read.
+  /// 'hit' tells whether the graph was already in the cache.
+  shared_ptr<const CsrGraph> get ( const string& name, bool& hit );
+
+  size_t size  ( void ) const;
+  size_t bytes ( void ) const;
+
+private:
+  struct Entry {
+    string                     name;
+    time_t                     mtime;
+    long                       mtimeNs;
+    off_t                      fsize;
+    size_t                     bytes;
+    shared_ptr<const CsrGraph> g;
+  };
+  typedef list<Entry>::iterator EntryIter;
+
+  /// Drop the least recently used graphs beyond the limits (lock held)
+  void evict ( void );
+
+  size_t                   maxGraphs;
+  size_t                   maxBytes;
+  size_t                   used;     /// Bytes held by the cached graphs
+  list<Entry>              lru;      /// Most recently used first
+  map<string,EntryIter>    index;
+  mutable mutex            lock;
+};
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef _MY_GRAPH_IO_
+#define _MY_GRAPH_IO_
+
+#include "csr_graph.hpp"
+
+/// Graph file formats understood by the converter
+enum GraphFormat {
+  FMT_UNKNOWN = 0,
+  FMT_COL,      /// DIMACS ascii: "p edge n m", "e i j" (1-based)
+  FMT_ORLIB,    /// OR-lib: "n m k", then one line of (1-based) neighbors per vertex
+  FMT_EDGES,    /// Edge list: "# n m" header (optional), one "i j" pair per line (0-based)
+  FMT_BIN,      /// DIMACS binary: triangular bitmap
+  FMT_CSR       /// Sparse binary CSR (see csr_graph.hpp)
+};
+
+/// Format name as given on the command line ("col", "orlib", "edges", "b", "csr")
+GraphFormat  format_from_name      ( const char* s );
+/// Guess the format from the file extension
+GraphFormat  format_from_extension ( const char* name );
+const char*  format_extension      ( GraphFormat f );
+
+/// Stream a graph file into an edge list over vertices 0..n-1 ('edges' is
+/// cleared first). Return false if the file cannot be read.
+bool read_edges ( const char* name, GraphFormat f, uint32_t& n, CsrEdgeList& edges );
+
+/// Load a graph for the engines: sparse binary files are opened in place,
+/// any other file is read as DIMACS binary. Return false if it cannot be read.
+bool read_graph ( CsrGraph& g, const char* name );
+
+/// Write the graph in the given format; return false on I/O error
+bool write_graph ( const CsrGraph& g, const char* name, GraphFormat f );
+
+/// Colors of the vertices, one per line (or blank separated)
+bool read_colors  ( const char* name, vector<unsigned int>& colors );
+bool write_colors ( const vector<unsigned int>& colors, const char* name );
+
+/// Edge changes, one per line: "+ i j" (added) or "- i j" (removed), 0-based;
+/// "#" starts a comment. Return false if the file cannot be read or is malformed.
+bool read_delta ( const char* name, CsrEdgeList& added, CsrEdgeList& removed );
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef _MY_GRAPH_ORDER_
+#define _MY_GRAPH_ORDER_
+
+#include "csr_graph.hpp"
+
+///------------------------------------------------------------------------------------------
+/// Vertex orderings for cache locality.
+///
+/// The engines walk the neighbors of the neighbors of every colored vertex:
+/// relabeling the vertices so that adjacent vertices get close indices keeps
+/// those walks within a few cache lines of the vertex arrays.
+enum GraphOrder {
+  ORDER_NONE = 0,   /// Input order
+  ORDER_DEGREE,     /// Decreasing degree (ties by index)
+  ORDER_RCM,        /// Reverse Cuthill-McKee
+  ORDER_COMMUNITY,  /// Label propagation communities, each in BFS order
+  NUM_ORDERS
+};
+
+/// Ordering by name ("none", "degree", "rcm", "community"); NUM_ORDERS if unknown
+GraphOrder   order_from_name ( const char* s );
+const char*  order_name      ( GraphOrder o );
+
+/// Compute the ordering: perm[i] is the vertex placed at position i
+void vertex_order ( const CsrGraph& g, GraphOrder o, vector<uint32_t>& perm );
+
+/// Relabel the graph: vertex perm[i] of g becomes vertex i of h
+void permute_graph ( const CsrGraph& g, const vector<uint32_t>& perm, CsrGraph& h );
+
+#endif
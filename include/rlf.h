@@ -0,0 +1,77 @@
+#ifndef _MY_RLF_C_
+#define _MY_RLF_C_
+
+/*
+ * C interface of librlf (see rlf.hpp for the C++ one).
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct rlf_graph rlf_graph;
+
+/* Engines, same values as rlf::Engine */
+enum {
+  RLF_ENGINE_RLF = 0,
+  RLF_ENGINE_PLUS,
+  RLF_ENGINE_LAZY,
+  RLF_ENGINE_ADAPTIVE,
+  RLF_ENGINE_DSATUR,
+  RLF_ENGINE_JP
+};
+
+/* Vertex orderings, same values as GraphOrder */
+enum {
+  RLF_ORDER_NONE = 0,
+  RLF_ORDER_DEGREE,
+  RLF_ORDER_RCM,
+  RLF_ORDER_COMMUNITY
+};
+
+typedef struct {
+  unsigned int seed;   /* seed of the random tie breaking */
+  double       dd;     /* density threshold of the adaptive engine */
+  int          order;  /* relabel the vertices before coloring (RLF_ORDER_*) */
+  double       time_limit;  /* anytime mode: improve for this many seconds (0: single run) */
+  unsigned int threads;     /* plus, adaptive, jp: threads of the run (same coloring) */
+  int          complement;  /* store the non-edges: 1 always, -1 never, 0 on dense graphs */
+  int          compress;    /* nonzero: keep the neighbor lists gap encoded */
+  int          hybrid;      /* nonzero: keep the neighbors of the hubs as bitsets */
+} rlf_options;
+
+/* Set the default options */
+void rlf_options_init ( rlf_options* opt );
+
+/* Build a graph from symmetric CSR arrays (off has n+1 entries) or from m
+ * edges given as pairs (edges[2k], edges[2k+1]). The arrays are copied,
+ * self loops and duplicated edges are dropped.
+ * Return NULL on failure: out of memory, a vertex not below n, decreasing
+ * offsets or CSR lists that are not symmetric. */
+rlf_graph* rlf_graph_from_csr   ( uint32_t n, const uint64_t* off, const uint32_t* adj );
+rlf_graph* rlf_graph_from_edges ( uint32_t n, const uint32_t* edges, uint64_t m );
+void       rlf_graph_free       ( rlf_graph* g );
+
+uint32_t   rlf_graph_num_vertices ( const rlf_graph* g );
+
+/* Color the graph with the given engine (opt may be NULL): colors must hold
+ * one entry per vertex and receives colors 1..X(G).
+ * Return X(G), or -1 if the engine cannot handle the graph. */
+int rlf_color ( const rlf_graph* g, int engine, const rlf_options* opt, uint32_t* colors );
+
+/* Update colors, a valid coloring of g, for g with na edges added and nr
+ * edges removed (pairs as in rlf_graph_from_edges): conflicts are repaired
+ * locally; if more than 'tolerance' new colors are needed, the changed graph
+ * is also colored from scratch and used if not worse. g itself is not changed.
+ * Return X(G) of the changed graph, or -1 on error. */
+int rlf_recolor ( const rlf_graph* g, const uint32_t* added, uint64_t na,
+		  const uint32_t* removed, uint64_t nr, int engine, const rlf_options* opt,
+		  unsigned int tolerance, uint32_t* colors );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
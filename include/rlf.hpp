@@ -0,0 +1,288 @@
+#ifndef _MY_RLF_
+#define _MY_RLF_
+
+#include "csr_graph.hpp"
+#include "graph_order.hpp"
+
+///------------------------------------------------------------------------------------------
+/// In-process API of the RLF engines (librlf).
+///
+/// A coloring needs only a CsrGraph: no process is spawned and no file is read.
+/// The engines keep all their state on the stack of the call, so different
+/// graphs can be colored at the same time from different threads.
+namespace rlf {
+
+  typedef unsigned int Color;
+
+  /// Available engines
+  enum Engine {
+    RLF = 0,    /// Porting of the PL-1 implementation (at most 32767 vertices)
+    PLUS,       /// Array based adjacency lists, degree to U kept up to date
+    LAZY,       /// Lazy RLF: degree to U computed on demand
+    ADAPTIVE,   /// Plus or Lazy for every color class, depending on the density
+    DSATUR,     /// DSATUR (Brelaz), not RLF: for comparisons on the same graphs
+    JP,         /// Jones-Plassmann parallel greedy, not RLF: fast first pass
+    NUM_ENGINES
+  };
+
+  /// Options of a run
+  struct Options {
+    Options ( void ) : seed(1), dd(0.0), order(ORDER_NONE), timeLimit(0.0), complement(0), compress(false), hybrid(false), threads(1), deadline(0), cutoff(0) {}
+
+    unsigned int seed;       /// Seed of the random tie breaking (as srand)
+    double       dd;         /// ADAPTIVE: density threshold for using the Lazy color classes
+    GraphOrder   order;      /// Relabel the vertices before coloring (colors are mapped back)
+    double       timeLimit;  /// Anytime mode: improve the coloring for this many seconds (0: single run)
+    int          complement; /// Store the non-edges: 1 always, -1 never, 0 on dense graphs
+    bool         compress;   /// Keep the neighbor lists gap encoded, decoded while walking
+    bool         hybrid;     /// Keep the neighbors of the hubs (degree >= n/32) as bitsets
+    unsigned int threads;    /// PLUS, ADAPTIVE, JP: threads of the run (same coloring); batches: threads
+
+    /// Set by the anytime driver: an engine run stops opening color classes
+    /// at the deadline (clock_ns() value) or beyond the cutoff color, and the
+    /// vertices left are colored first fit (0: none)
+    uint64_t     deadline;
+    Color        cutoff;
+  };
+
+  /// Monotonic clock, in nanoseconds
+  uint64_t clock_ns ( void );
+
+  /// Engine by name ("rlf", "plus", "lazy", "adaptive", "dsatur", "jp"); NUM_ENGINES if unknown
+  Engine       engine_from_name ( const char* s );
+  const char*  engine_name      ( Engine e );
+
+  /// Color the graph: colors[v] is set to the color (1..X(G)) of vertex v.
+  /// Return the number of colors, 0 if the engine cannot handle the graph.
+  /// With Options::order the engine runs on the relabeled graph; ties follow
+  /// the new order, so the coloring may differ from the one in input order.
+  /// PLUS, LAZY and ADAPTIVE color graphs of at most 512 vertices without
+  /// allocating (rlf_small.hpp), apart from sizing 'colors'.
+  Color color ( const CsrGraph& g, Engine e, const Options& opt, vector<Color>& colors );
+
+  /// Why a run of e on g would not share its color classes among
+  /// Options::threads threads, NULL if it would (or if it takes one thread):
+  /// the engine has no threaded layout, or the layout picked first is the
+  /// small, complement, compressed or hybrid one, or the graph has too few
+  /// adjacency entries for any step to reach PARALLEL_MIN_WORK.
+  const char* threads_unused ( const CsrGraph& g, Engine e, const Options& opt );
+
+  /// Give every vertex of color 0 the smallest color not used by its neighbors;
+  /// return the number of colors
+  Color first_fit ( const CsrGraph& g, vector<Color>& colors );
+
+  /// Build a graph from symmetric CSR arrays (copied, neighbor lists are
+  /// sorted, self loops and duplicates dropped). Return false if the offsets
+  /// decrease, a neighbor is not below n or the lists are not symmetric.
+  bool graph_from_csr   ( CsrGraph& g, uint32_t n, const uint64_t* off, const uint32_t* adj );
+  /// Build a graph from m edges given as pairs edges[2k], edges[2k+1]
+  /// (0-based, self loops and duplicates dropped). Return false if an end is
+  /// not below n.
+  bool graph_from_edges ( CsrGraph& g, uint32_t n, const uint32_t* edges, uint64_t m );
+
+  ///--------------------------------------------------
+  /// Incremental recoloring
+
+  /// Edge changes between two versions of a graph on the same vertices (0-based)
+  struct EdgeDelta {
+    CsrEdgeList added;
+    CsrEdgeList removed;
+  };
+
+  struct RecolorOptions {
+    RecolorOptions ( void ) : engine(PLUS), tolerance(1) {}
+
+    Engine       engine;     /// Engine of the local and full runs
+    Options      opt;
+    unsigned int tolerance;  /// New colors accepted before falling back to a full run
+  };
+
+  struct RecolorStats {
+    RecolorStats ( void ) : conflicts(0), greedy(0), kempe(0), local(0), full(false) {}
+
+    size_t conflicts;   /// Added edges with both ends of the same color
+    size_t greedy;      /// Vertices moved to a free existing color
+    size_t kempe;       /// Vertices recolored by a Kempe chain swap
+    size_t local;       /// Vertices colored by RLF on their induced subgraph
+    bool   full;        /// The coloring comes from a full run
+  };
+
+  /// Update 'colors', a valid coloring of g, into a coloring of g changed by
+  /// 'delta'. One end of every conflicting added edge is uncolored, then every
+  /// uncolored vertex takes a free existing color if any, else a Kempe chain
+  /// swap frees one; the rest are colored by RLF on their induced subgraph with
+  /// new colors. If more than 'tolerance' colors are added, the changed graph
+  /// is also colored from scratch, and that coloring is taken if it uses no
+  /// more colors. Apart from a pass over the colors and that fallback, the work
+  /// depends only on the changed vertices and their neighborhoods.
+  /// Return the number of colors, 0 on error (bad vertex, engine failure).
+  Color recolor ( const CsrGraph& g, const EdgeDelta& delta, const RecolorOptions& ropt,
+		  vector<Color>& colors, RecolorStats* stats );
+
+  ///--------------------------------------------------
+  /// Partitioned coloring
+
+  struct PartitionStats {
+    PartitionStats ( void ) : parts(0), cut(0), boundary(0), interior(0),
+			      partSeconds(0.0), interiorSeconds(0.0), boundarySeconds(0.0) {}
+
+    unsigned int parts;
+    uint64_t     cut;              /// Edges between different parts
+    size_t       boundary;         /// Vertices with a neighbor in another part
+    Color        interior;         /// Colors used by the interiors
+    double       partSeconds;      /// Partitioning
+    double       interiorSeconds;  /// Interiors, in parallel
+    double       boundarySeconds;  /// Boundary pass
+  };
+
+  /// Color g in 'parts' balanced parts with few cut edges (reverse
+  /// Cuthill-McKee blocks refined by label propagation). The interior of
+  /// every part (its vertices without neighbors elsewhere) is colored by
+  /// engine e, Options::threads parts at a time; the interiors share the
+  /// colors, having no edges between them. The boundary vertices are then
+  /// colored by a sequential RLF pass that builds the classes in color order,
+  /// leaving out of each class the vertices next to an interior vertex of
+  /// that color. Return the number of colors, 0 if the engine fails on a part.
+  Color color_partitioned ( const CsrGraph& g, Engine e, const Options& opt, unsigned int parts,
+			    vector<Color>& colors, PartitionStats* stats );
+
+  ///--------------------------------------------------
+  /// Speculative pipelining (experimental)
+
+  struct SpeculateStats {
+    SpeculateStats ( void ) : classes(0), tried(0), adopted(0), seconds(0.0) {}
+
+    Color   classes;   /// Color classes
+    size_t  tried;     /// Classes built ahead by the second thread
+    size_t  adopted;   /// Classes built ahead that passed the validation
+    double  seconds;
+  };
+
+  /// PLUS on the structure of arrays layout, with class k+1 built ahead by
+  /// a second thread on a copy of the state while class k is completed. The
+  /// copy is taken at most once per class, when the vertex selected has no
+  /// edge left: the rest of class k is then expected to take only such
+  /// vertices. Once class k is complete, the class built ahead is kept if U
+  /// and the degrees of its vertices are those of the copy, and built again
+  /// otherwise, so the coloring is the one of color( g, PLUS, opt ). The
+  /// anytime options are ignored. Return the number of colors, 0 if the
+  /// graph is too large.
+  Color color_speculative ( const CsrGraph& g, const Options& opt, vector<Color>& colors,
+			    SpeculateStats* stats );
+
+  ///--------------------------------------------------
+  /// Batch coloring
+
+  /// Many graphs packed in shared CSR arrays: graph i owns the vertices
+  /// first[i] .. first[i+1]-1 of the batch, numbered from 0 within the graph;
+  /// the neighbors of its vertex v are adj[off[first[i]+v]] ... (sorted, every
+  /// edge in both directions), off holding one entry per vertex of the batch
+  /// plus one
+  struct GraphBatch {
+    GraphBatch ( void ) : graphs(0), first(NULL), off(NULL), adj(NULL) {}
+
+    size_t          graphs;
+    const uint64_t* first;   /// graphs+1 entries, first[0] = 0
+    const uint64_t* off;
+    const uint32_t* adj;
+  };
+
+  struct BatchStats {
+    BatchStats ( void ) : graphs(0), vertices(0), failed(0), seconds(0.0) {}
+
+    size_t   graphs;
+    uint64_t vertices;
+    size_t   failed;    /// Graphs the engine could not color
+    double   seconds;
+  };
+
+  /// Color every graph of the batch with engine e: colors[first[i]+v] gets
+  /// the color of vertex v of graph i, and k[i] (if not NULL) the number of
+  /// colors of graph i (0 if the engine fails on it). The graphs are shared
+  /// out to Options::threads threads in chunks; each thread keeps its scratch
+  /// arrays from one graph to the next, and graphs of at most 512 vertices
+  /// (PLUS, LAZY, ADAPTIVE) are colored on the stack, without allocating.
+  /// Return the number of graphs colored.
+  size_t color_batch ( const GraphBatch& b, Engine e, const Options& opt, Color* colors, Color* k,
+		       BatchStats* stats );
+
+  ///--------------------------------------------------
+  /// Out-of-core coloring
+
+  struct ExternalOptions {
+    ExternalOptions ( void ) : passes(8), memory(64), buffer(16) {}
+
+    unsigned int passes;   /// Passes over the file for every color class (2 to 64)
+    size_t       memory;   /// MB for the neighbor lists of a batch
+    size_t       buffer;   /// MB read at a time
+  };
+
+  struct ExternalStats {
+    ExternalStats ( void ) : passes(0), bytes(0), seconds(0.0) {}
+
+    size_t   passes;   /// Passes over the file
+    uint64_t bytes;    /// Bytes read
+    double   seconds;
+  };
+
+  /// Color the graph of a sparse binary file (.csr) without loading its
+  /// neighbors: only O(n) per vertex state is kept in memory and the neighbor
+  /// section is read sequentially, at most ExternalOptions::passes times per
+  /// color class, the selections of a class being done in batches between
+  /// passes. Return the number of colors, 0 if the file cannot be read.
+  Color color_external ( const char* file, const ExternalOptions& xopt, vector<Color>& colors,
+			 ExternalStats* stats );
+
+  ///--------------------------------------------------
+  /// Lower bound
+
+  /// Size of a clique of g (a lower bound of its chromatic number), found
+  /// from the vertices of highest degree: greedily along the neighbors by
+  /// degree, and on a bitset matrix of each neighborhood keeping the
+  /// candidate adjacent to most of the others. The clique goes to 'clique'
+  /// (if not NULL).
+  Color clique_bound ( const CsrGraph& g, vector<uint32_t>* clique );
+
+  ///--------------------------------------------------
+  /// TabuCol post-optimization
+
+  struct TabuOptions {
+    TabuOptions ( void ) : iterations(100000), timeLimit(0.0), seed(1), tenure(10), alpha(0.6), bound(0) {}
+
+    size_t       iterations;  /// Moves tried for every number of colors
+    double       timeLimit;   /// Seconds for the whole search (0: no limit)
+    unsigned int seed;        /// Seed of the random choices
+    unsigned int tenure;      /// Tabu tenure: random in [0,tenure) ...
+    double       alpha;       /// ... plus alpha times the conflicting vertices
+    Color        bound;       /// Stop at this number of colors (a lower bound)
+  };
+
+  /// One attempt with k colors
+  struct TabuPhase {
+    Color  k;
+    bool   solved;       /// A conflict free coloring was found
+    size_t iterations;   /// Moves made
+    size_t conflicts;    /// Conflicting edges at the start
+    double seconds;
+  };
+
+  /// Improve a valid coloring by TabuCol: the smallest class is dropped, its
+  /// vertices moved to the classes where they have fewest conflicts, and the
+  /// conflicts are repaired by tabu search over one-vertex moves, using an
+  /// n x k table of the neighbors of every vertex in every class; then again
+  /// with one color less, until an attempt fails. 'colors' receives the best
+  /// coloring found and every attempt is appended to 'phases' (if not NULL).
+  /// Return the number of colors.
+  Color tabucol ( const CsrGraph& g, vector<Color>& colors, const TabuOptions& topt,
+		  vector<TabuPhase>* phases );
+
+  /// The engines
+  Color color_rlf      ( const CsrGraph& g, const Options& opt, vector<Color>& colors );
+  Color color_plus     ( const CsrGraph& g, const Options& opt, vector<Color>& colors );
+  Color color_lazy     ( const CsrGraph& g, const Options& opt, vector<Color>& colors );
+  Color color_adaptive ( const CsrGraph& g, const Options& opt, vector<Color>& colors );
+  Color color_dsatur   ( const CsrGraph& g, const Options& opt, vector<Color>& colors );
+  Color color_jp       ( const CsrGraph& g, const Options& opt, vector<Color>& colors );
+}
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef _MY_RLF_ANYTIME_
+#define _MY_RLF_ANYTIME_
+
+#include <atomic>
+#include <memory>
+
+#include "rlf.hpp"
+
+namespace rlf {
+
+///------------------------------------------------------------------------------------------
+/// Anytime coloring under a wall-clock budget (Options::timeLimit).
+///
+/// A first RLF run gives a coloring (finished first fit if the deadline
+/// comes first); then, until the deadline, the color classes of the best
+/// coloring are emptied one at a time when all their vertices fit in other
+/// classes, and RLF is run again with the next seeds, stopping as soon as a
+/// run cannot beat the best. The search ends early when the best meets the
+/// clique lower bound, computed after the first run if time is left. Every improvement
+/// is published atomically: best() can be called from another thread while run() works.
+class Anytime {
+public:
+  Anytime ( const CsrGraph& g, Engine e, const Options& opt );
+
+  /// Improve until the deadline; return the best number of colors (0 on failure)
+  Color run ( void );
+
+  /// Best coloring so far, and its number of colors
+  Color best ( vector<Color>& colors ) const;
+
+  /// Engine runs and class eliminations done so far
+  size_t runs         ( void ) const { return nRuns; }
+  size_t eliminations ( void ) const { return nElim; }
+
+  /// Clique lower bound (0 before run(), or if the first run took the whole budget)
+  Color bound ( void ) const { return lb; }
+
+private:
+  void publish ( const vector<Color>& colors, Color k );
+  bool expired ( void ) const { return clock_ns() >= deadline; }
+
+  /// Move every vertex of one color class to other classes; false if no class can be emptied
+  bool eliminate ( vector<Color>& colors, Color k );
+
+  typedef std::shared_ptr< const vector<Color> > ColorsPtr;
+
+  const CsrGraph&     g;
+  Engine              engine;
+  Options             opt;
+  uint64_t            deadline;
+  ColorsPtr           bestColors;  /// Swapped with atomic_store, read with atomic_load
+  std::atomic<Color>  bestK;
+  std::atomic<Color>  lb;
+  std::atomic<size_t> nRuns;
+  std::atomic<size_t> nElim;
+  vector<uint32_t>    used;   /// eliminate(): colors around the vertex (== stamp)
+  uint32_t            stamp;
+};
+
+} // namespace rlf
+
+#endif
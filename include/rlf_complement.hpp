@@ -0,0 +1,276 @@
+#ifndef _MY_RLF_COMPLEMENT_
+#define _MY_RLF_COMPLEMENT_
+
+#include <algorithm>
+
+#include "rlf_engine.hpp"
+
+namespace rlf {
+
+///------------------------------------------------------------------------------------------
+/// Complement layout for dense graphs: the lists hold the non-neighbors of
+/// every vertex, and the engine quantities are derived from them,
+///
+///   degree(v)  = (live vertices - 1) - live non-neighbors of v
+///   |N(v) ∩ U| = |U| - non-neighbors of v in U
+///
+/// so that the memory and the degree updates follow the non-edges: coloring a
+/// vertex or moving it to U walks its non-neighbors. The neighbors of v in P
+/// are the vertices of the P array not marked as non-neighbors, so a step
+/// still walks P: O(k + |N̄(v)|) for the k vertices it moves, since the other
+/// vertices of P are v and its non-neighbors, plus O(k log k) to sort them
+/// unless they come out of P in increasing order, as in the first class.
+/// They move to U in increasing order, as from a sorted adjacency list, so
+/// the colorings are the same as with the other layouts. Building the lists
+/// takes O(n²) time whatever m, which only pays on dense graphs. Membership
+/// in P is stamped with the class number, as in SoALayout.
+template <class Index>
+class ComplementLayout {
+public:
+  static const Index NIL = Index(-1);
+
+  static bool fits ( const CsrGraph& g ) {
+    return uint64_t(g.n) < NIL && uint64_t(g.n) * (g.n-1) - 2*g.m < NIL;
+  }
+
+  ComplementLayout ( const CsrGraph& g, const Options& )
+    : n(g.n), live(g.n), start(g.n), len(g.n), dbar(g.n), ubar(g.n, 0),
+      pe(g.n, 1), epoch(1), alive(g.n, 1), c(g.n, 0), mark(g.n, 0), stamp(0), P(g.n), pLive(g.n), pDead(0) {
+    nb.reserve( size_t( uint64_t(g.n) * (g.n-1) - 2*g.m ) );
+    for ( Index v = 0; v < n; v++ ) {
+      start[v] = Index( nb.size() );
+      const uint32_t* a = g.adj + g.off[v];
+      const uint32_t* e = g.adj + g.off[v+1];
+      for ( Index w = 0; w < n; w++ ) {
+	if ( a != e && *a == w )
+	  ++a;
+	else if ( w != v )
+	  nb.push_back( w );
+      }
+      len[v]  = dbar[v] = Index( nb.size() ) - start[v];
+      P[v]    = v;
+    }
+    U.reserve( n );
+  }
+
+  /// Iterator over the vertices in P
+  class PIter {
+  public:
+    explicit PIter ( const ComplementLayout& L0 ) : L(L0), i(0), k(L0.P.size()) { next(); }
+    inline bool  operator()() const { return i != k; }
+    inline void  operator++()       { ++i; next(); }
+    inline Index operator* () const { return L.P[i]; }
+    /// Skip the vertices of degree lower than dmin
+    inline void  seek ( Index dmin ) { while ( i != k && L.degree( L.P[i] ) < dmin ) { ++i; next(); } }
+  private:
+    inline void next ( void ) { while ( i != k && !L.inP( L.P[i] ) ) ++i; }
+    const ComplementLayout& L;
+    size_t                  i;
+    size_t                  k;
+  };
+
+  inline PIter pIter ( void ) const { return PIter( *this ); }
+
+  inline Index degree   ( Index v ) const { return live - 1 - dbar[v]; }
+  inline Index degreeU  ( Index v ) const { return Index( U.size() ) - ubar[v]; }
+  inline bool  inP      ( Index v ) const { return pe[v] == epoch; }
+  inline Color color    ( Index v ) const { return c[v];   }
+  inline void  setColor ( Index v, Color c0 ) { c[v] = c0; }
+  inline bool  empty    ( void )    const { return pLive == 0; }
+
+  /// Vertex of P with maximum degree (fewest non-neighbors), ties broken at random
+  Index maxDegree ( Random& rng ) {
+    compactP();
+    Index v = P[0];
+    for ( size_t i = 1; i < P.size(); i++ ) {
+      Index w = P[i];
+      if ( ( dbar[w] < dbar[v] ) ||
+	   ( dbar[w] == dbar[v] && rng()%2 ) )
+	v = w;
+    }
+    return v;
+  }
+
+  /// Vertex of P with maximum degree to U, ties broken by minimum degree
+  Index argmaxU ( void ) {
+    compactP();
+    Index v = P[0];
+    for ( size_t i = 1; i < P.size(); i++ ) {
+      Index w = P[i];
+      if ( ( ubar[w] < ubar[v] ) ||
+	   ( ubar[w] == ubar[v] && dbar[w] > dbar[v] ) )
+	v = w;
+    }
+    return v;
+  }
+
+  /// Move w from P to the back of U
+  inline void moveToU ( Index w ) {
+    pe[w]   = epoch + 1;
+    ubar[w] = 0;
+    pLive--;
+    pDead++;
+    U.push_back( w );
+  }
+
+  /// Remove v from P
+  inline void removeFromP ( Index v ) {
+    pe[v] = 0;
+    pLive--;
+    pDead++;
+  }
+
+  /// Remove v from the graph: its live non-neighbors lose one non-neighbor
+  inline void clearVertex ( Index v ) {
+    const Index* a = nonNeighbors( v );
+    for ( Index i = 0; i < len[v]; i++ )
+      if ( alive[a[i]] )
+	dbar[a[i]]--;
+    alive[v] = 0;
+    live--;
+  }
+
+  /// U becomes the new P, in O(1): its vertices carry the next class stamp
+  template <bool counted>
+  void swap ( void ) {
+    P.swap( U );
+    U.clear();
+    pLive = P.size();
+    pDead = 0;
+    epoch++;
+  }
+
+  ///--------------------------------------------------
+  /// Neighborhood operations of the engine (see rlf_engine.hpp)
+
+  template <bool counted>
+  void moveNeighborsToU ( Index v ) {
+    compactP();
+    markNonNeighbors( v );
+    size_t first = U.size();
+    bool   sorted = true;
+    for ( size_t i = 0; i < P.size(); i++ ) {
+      Index w = P[i];
+      if ( w != v && pe[w] == epoch && mark[w] != stamp ) {
+	sorted = sorted && ( U.size() == first || U.back() < w );
+	U.push_back( w );
+      }
+    }
+    if ( !sorted )
+      std::sort( U.begin() + first, U.end() );
+    for ( size_t i = first; i < U.size(); i++ ) {
+      Index w = U[i];
+      pe[w]   = epoch + 1;
+      ubar[w] = 0;
+      pLive--;
+      pDead++;
+      /// The non-neighbors of w in P gain one non-neighbor in U
+      if ( counted ) {
+	const Index* a = nonNeighbors( w );
+	for ( Index j = 0; j < len[w]; j++ )
+	  ubar[a[j]] += ( pe[a[j]] == epoch );
+      }
+    }
+  }
+
+  Index degreeToP ( Index v ) {
+    Index np = 0;
+    const Index* a = nonNeighbors( v );
+    for ( Index i = 0; i < len[v]; i++ )
+      np += ( pe[a[i]] == epoch );
+    return Index( pLive ) - 1 - np;
+  }
+
+  Index degreeToU ( Index w, Index du_max ) {
+    if ( degree( w ) < du_max )
+      return 0;
+    Index        du = Index( U.size() );
+    const Index* a  = nonNeighbors( w );
+    for ( Index i = 0; i < len[w]; i++ )
+      if ( pe[a[i]] == epoch + 1 && --du < du_max )
+	return du;
+    return du;
+  }
+
+private:
+  /// Live entries of the list of v, compacted (in order) when a fifth are dead
+  inline const Index* nonNeighbors ( Index v ) {
+    Index* a = &nb[0] + start[v];
+    if ( len[v] > dbar[v] + dbar[v]/4 + 8 ) {
+      Index k = 0;
+      for ( Index i = 0; i < len[v]; i++ )
+	if ( alive[a[i]] )
+	  a[k++] = a[i];
+      len[v] = k;
+    }
+    return a;
+  }
+
+  void markNonNeighbors ( Index v ) {
+    if ( ++stamp == 0 ) {
+      std::fill( mark.begin(), mark.end(), 0 );
+      stamp = 1;
+    }
+    const Index* a = nonNeighbors( v );
+    for ( Index i = 0; i < len[v]; i++ )
+      mark[a[i]] = stamp;
+  }
+
+  /// Drop the vertices no longer in P from the P array, keeping the order
+  inline void compactP ( void ) {
+    if ( pDead == 0 )
+      return;
+    size_t k = 0;
+    for ( size_t i = 0; i < P.size(); i++ )
+      if ( pe[P[i]] == epoch )
+	P[k++] = P[i];
+    P.resize( k );
+    pDead = 0;
+  }
+
+  Index                      n;
+  Index                      live;   /// Vertices not colored yet
+  GraphVector<Index>         start;  /// First non-neighbor of every vertex in nb
+  GraphVector<Index>         len;    /// Length of the list (live and dead entries)
+  GraphVector<Index>         nb;     /// Non-neighbors
+  GraphVector<Index>         dbar;   /// Live non-neighbors
+  GraphVector<Index>         ubar;   /// Non-neighbors in U (vertices in P only)
+  GraphVector<uint32_t>      pe;     /// Class whose P holds the vertex (0: colored)
+  uint32_t                   epoch;  /// Class being built
+  GraphVector<unsigned char> alive;  /// If the vertex is not colored yet
+  GraphVector<Color>         c;      /// Color of the vertex
+  GraphVector<uint32_t>      mark;   /// Non-neighbors of the last selected vertex (== stamp)
+  uint32_t                   stamp;
+  GraphVector<Index>         P;      /// Vertices in P, in order (may hold vertices that left P)
+  GraphVector<Index>         U;      /// Vertices in U, in order
+  size_t                     pLive;  /// Vertices in P
+  size_t                     pDead;  /// Entries of the P array no longer in P
+};
+
+template <bool counted, class Index>
+inline void move_neighbors_to_u ( ComplementLayout<Index>& G, Index v ) {
+  G.template moveNeighborsToU<counted>( v );
+}
+
+template <class Index>
+inline Index degree_to_p ( ComplementLayout<Index>& G, Index v ) {
+  return G.degreeToP( v );
+}
+
+template <class Index>
+inline Index degree_to_u ( ComplementLayout<Index>& G, Index w, Index du_max ) {
+  return G.degreeToU( w, du_max );
+}
+
+/// Use the complement layout: always (Options::complement > 0), never (< 0),
+/// or when the graph is denser than 'density' (0). The counted engines gain
+/// from density 1/2; the scanning ones, which stop early on the edges, later.
+inline bool use_complement ( const CsrGraph& g, const Options& opt, double density ) {
+  if ( opt.complement < 0 || !ComplementLayout<uint32_t>::fits( g ) )
+    return false;
+  return opt.complement > 0 || ( g.n > 1 && 2.0*g.m > density * double(g.n) * (g.n-1) );
+}
+
+} // namespace rlf
+
+#endif
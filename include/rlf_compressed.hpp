@@ -0,0 +1,115 @@
+#ifndef _MY_RLF_COMPRESSED_
+#define _MY_RLF_COMPRESSED_
+
+#include "rlf_soa.hpp"
+
+namespace rlf {
+
+///------------------------------------------------------------------------------------------
+/// Structure of arrays layout on compressed neighbor lists: every list is
+/// gap encoded in the StreamVByte format (simd::encode_gaps), its control
+/// bytes followed by its data bytes, one byte per gap below 256. The
+/// iterators decode a block of CL_BLOCK neighbors at a time on their own
+/// stack while walking.
+///
+/// The lists are never changed: colored vertices are set in a bitmap, one bit
+/// per vertex, and skipped by the iterators. Selections and orders are those
+/// of SoALayout, so the colorings are the same.
+static const size_t CL_BLOCK = 32;
+
+template <class Index>
+class CompressedLayout : public SoALayout<Index> {
+public:
+  typedef SoALayout<Index> Base;
+
+  static bool fits ( const CsrGraph& g ) {
+    return Base::fits( g ) && uint64_t(g.n) <= UINT32_MAX;
+  }
+
+  CompressedLayout ( const CsrGraph& g, const Options& opt )
+    : Base( g, opt, false ), at(g.n+1), dead((g.n+63)/64, 0) {
+    /// Sizes first, then the lists in place
+    uint64_t bytes = 0;
+    for ( uint32_t v = 0; v < g.n; v++ ) {
+      at[v] = bytes;
+      bytes += ( g.degree( v ) + 3 ) / 4;
+      uint32_t prev = 0;
+      for ( uint64_t p = g.off[v]; p < g.off[v+1]; p++ ) {
+	uint32_t x = g.adj[p] - prev;
+	bytes += ( x < (1U << 8) ) ? 1 : ( x < (1U << 16) ) ? 2 : ( x < (1U << 24) ) ? 3 : 4;
+	prev = g.adj[p];
+      }
+    }
+    at[g.n] = bytes;
+    lists.resize( bytes + 16 );
+    for ( uint32_t v = 0; v < g.n; v++ )
+      simd::encode_gaps( g.adj + g.off[v], g.degree( v ), &lists[at[v]],
+			 &lists[at[v] + ( g.degree( v ) + 3 ) / 4] );
+    /// The plain lists and flags of the base are not used
+    GraphVector<Index>().swap( this->start );
+    GraphVector<unsigned char>().swap( this->alive );
+  }
+
+  ///--------------------------------------------------
+  /// Iterator over the live neighbors of a vertex, decoding as it goes
+  class AdjIter {
+  public:
+    AdjIter ( const unsigned char* ctrl0, size_t k, const uint64_t* dead0 )
+      : ctrl(ctrl0), data(ctrl0 + (k+3)/4), left(k), prev(0), i(0), m(0), dead(dead0) { fill( CL_BLOCK ); next(); }
+    inline bool  operator()() const { return i != m; }
+    inline void  operator++()       { ++i; next(); }
+    inline Index node      () const { return Index( buf[i] ); }
+  private:
+    inline void fill ( size_t block ) {
+      m = ( left < block ) ? left : block;
+      i = 0;
+      if ( m == 0 )
+	return;
+      data += simd::decode_gaps( ctrl, data, m, prev, buf );
+      ctrl += m / 4;
+      prev  = buf[m-1];
+      left -= m;
+    }
+    inline void next ( void ) {
+      for ( ;; ) {
+	while ( i != m && ( dead[buf[i] >> 6] >> ( buf[i] & 63 ) & 1 ) )
+	  ++i;
+	if ( i != m || left == 0 )
+	  return;
+	fill( CL_BLOCK );
+      }
+    }
+    const unsigned char* ctrl;
+    const unsigned char* data;
+    size_t               left;   /// Entries not decoded yet
+    uint32_t             prev;
+    size_t               i;
+    size_t               m;      /// Entries decoded in buf
+    const uint64_t*      dead;
+    uint32_t             buf[CL_BLOCK];
+  };
+
+  inline AdjIter adj ( Index v ) const {
+    return AdjIter( &lists[at[v]], this->len[v], &dead[0] );
+  }
+
+  /// Remove every edge incident to v: its neighbors lose a degree, and v is
+  /// set in the bitmap of colored vertices
+  inline void clearVertex ( Index v ) {
+    for ( AdjIter w = adj( v ); w(); ++w )
+      this->d[w.node()]--;
+    dead[v >> 6] |= uint64_t(1) << ( v & 63 );
+  }
+
+  /// Bytes of the compressed lists
+  uint64_t listBytes ( void ) const { return at[this->n]; }
+
+private:
+  GraphVector<uint64_t>      at;     /// First control byte of every list (n+1 entries)
+  GraphVector<unsigned char> lists;  /// Control and data bytes of the lists, 16 bytes of padding
+  GraphVector<uint64_t>      dead;   /// Colored vertices, one bit each
+};
+
+} // namespace rlf
+
+#endif
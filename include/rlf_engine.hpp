@@ -0,0 +1,390 @@
+#ifndef _MY_RLF_ENGINE_
+#define _MY_RLF_ENGINE_
+
+#include <cassert>
+#include <limits>
+
+#include "rlf.hpp"
+#include "rlf_random.hpp"
+
+///------------------------------------------------------------------------------------------
+/// Header-only RLF engine, specialized at compile time by four policies:
+///
+///   Selection  which degree-to-U policy colors the next class
+///              (StaticSelection: always the given one; DensitySelection:
+///               ScannedU when the residual graph is denser than Options::dd)
+///   DegreeToU  how |N(v) ∩ U| is obtained
+///              (CountedU: counters kept up to date by the moves, as in rlfPlus;
+///               ScannedU: recomputed on demand with early exit, as in lazyRlf)
+///   Layout     data structure holding the residual graph and the P/U lists
+///   Index      integer type of the vertex and adjacency indices
+///
+/// The policies are resolved at compile time: every combination gets its own
+/// code, with no run-time test on the policy in the inner loops.
+///------------------------------------------------------------------------------------------
+
+namespace rlf {
+
+/// Degree-to-U policies
+struct CountedU { static const bool counted = true;  };
+struct ScannedU { static const bool counted = false; };
+
+/// Selection policies
+struct StaticSelection {
+  template <class DegreeToU, class E>
+  static unsigned int color_class ( E& e, Color c, const Options& ) {
+    return e.template new_color_class<DegreeToU>( c );
+  }
+};
+
+struct DensitySelection {
+  template <class DegreeToU, class E>
+  static unsigned int color_class ( E& e, Color c, const Options& opt ) {
+    if ( e.density() >= opt.dd )
+      return e.template new_color_class<ScannedU>( c );
+    return e.template new_color_class<DegreeToU>( c );
+  }
+};
+
+///------------------------------------------------------------------------------------------
+/// Array based doubly linked lists (the layout of the original engines):
+/// one record per vertex, threaded in the P and U lists, and one node per
+/// adjacency entry, skipped from the list of the neighbor when a vertex is colored.
+/// Membership in P is stamped with the class number (see SoALayout).
+template <class Index>
+class LinkedLayout {
+public:
+  static const Index NIL = Index(-1);
+
+  /// Largest graph the index type can address
+  static bool fits ( const CsrGraph& g ) {
+    return uint64_t(g.n) + 2 < NIL && 2*g.m + g.n < NIL;
+  }
+
+  LinkedLayout ( const CsrGraph& g, const Options& ) : n(g.n), P(g.n), U(g.n+1), epoch(1), vs(g.n+2), as(2*g.m+g.n) {
+    /// Head node of every adjacency list, then the neighbors in increasing order
+    vector<Index> next( n );
+    for ( Index v = 0; v < n; v++ ) {
+      vs[v].as = Index(g.off[v] + v);
+      vs[v].d  = Index(g.degree(v));
+      next[v]  = vs[v].as + 1;
+      vs[v].pre = ( v > 0 ) ? v-1 : P;
+      vs[v].suc = ( v+1 < n ) ? v+1 : NIL;
+    }
+    vs[P].suc = ( n > 0 ) ? 0 : NIL;
+    vs[U].suc = NIL;
+    vs[U].pre = U;
+
+    for ( Index v = 0; v < n; v++ ) {
+      Index h = vs[v].as;
+      for ( Index k = 0; k <= vs[v].d; k++ ) {
+	as[h+k].pre = ( k > 0 ) ? h+k-1 : NIL;
+	as[h+k].suc = ( k < vs[v].d ) ? h+k+1 : NIL;
+      }
+      for ( uint64_t p = g.off[v]; p < g.off[v+1]; p++ ) {
+	Index w = g.adj[p];
+	if ( w > v ) {
+	  Index p_i = next[v]++;
+	  Index p_j = next[w]++;
+	  as[p_i].node = w;  as[p_i].pos = p_j;
+	  as[p_j].node = v;  as[p_j].pos = p_i;
+	}
+      }
+    }
+  }
+
+  ///--------------------------------------------------
+  /// Iterator over the live neighbors of a vertex
+  class AdjIter {
+  public:
+    AdjIter ( const LinkedLayout& L, Index v ) : as(&L.as[0]), a(L.as[L.vs[v].as].suc) {}
+    inline bool  operator()() const { return a != NIL; }
+    inline void  operator++()       { a = as[a].suc; }
+    inline Index node      () const { return as[a].node; }
+  private:
+    const typename LinkedLayout::AdjNode* as;
+    Index a;
+  };
+
+  /// Iterator over the vertices in P
+  class PIter {
+  public:
+    explicit PIter ( const LinkedLayout& L ) : vs(&L.vs[0]), w(L.vs[L.P].suc) {}
+    inline bool  operator()() const { return w != NIL; }
+    inline void  operator++()       { w = vs[w].suc; }
+    inline Index operator* () const { return w; }
+    /// Skip the vertices of degree lower than dmin
+    inline void  seek ( Index dmin ) { while ( w != NIL && vs[w].d < dmin ) w = vs[w].suc; }
+  private:
+    const typename LinkedLayout::Vertex* vs;
+    Index w;
+  };
+
+  inline AdjIter adj   ( Index v ) const { return AdjIter( *this, v ); }
+  inline PIter   pIter ( void )    const { return PIter( *this );      }
+
+  inline Index degree   ( Index v ) const { return vs[v].d;   }
+  inline Index degreeU  ( Index v ) const { return vs[v].u;   }
+  inline bool  inP      ( Index v ) const { return vs[v].pe == epoch; }
+  inline void  incU     ( Index v )       { vs[v].u += ( vs[v].pe == epoch ); }
+  inline Color color    ( Index v ) const { return vs[v].c;   }
+  inline void  setColor ( Index v, Color c ) { vs[v].c = c;   }
+  inline bool  empty    ( void )    const { return vs[P].suc == NIL; }
+
+  /// Vertex of P with maximum degree, ties broken at random
+  Index maxDegree ( Random& rng ) const {
+    Index v = vs[P].suc;
+    for ( Index w = vs[v].suc; w != NIL; w = vs[w].suc )
+      if ( ( vs[w].d > vs[v].d ) ||
+	   ( vs[w].d == vs[v].d && rng()%2 ) )
+	v = w;
+    return v;
+  }
+
+  /// Vertex of P with maximum degree to U, ties broken by minimum degree
+  Index argmaxU ( void ) const {
+    Index v = vs[P].suc;
+    Index du_max = vs[v].u;
+    for ( Index w = vs[v].suc; w != NIL; w = vs[w].suc ) {
+      Index du = vs[w].u;
+      if ( ( du > du_max ) ||
+	   ( du == du_max && vs[w].d < vs[v].d ) ) {
+	du_max = du;
+	v      = w;
+      }
+    }
+    return v;
+  }
+
+  /// Move w from P to the back of U
+  inline void moveToU ( Index w ) {
+    skip( w );
+    vs[w].suc = NIL;
+    vs[w].pre = vs[U].pre;
+    vs[vs[U].pre].suc = w;
+    vs[U].pre = w;
+    vs[w].pe  = epoch + 1;
+    vs[w].u   = 0;
+  }
+
+  /// Remove v from P
+  inline void removeFromP ( Index v ) {
+    skip( v );
+    vs[v].pe = 0;
+  }
+
+  /// Remove every edge incident to v from the lists of its neighbors
+  inline void clearVertex ( Index v ) {
+    for ( Index a = as[vs[v].as].suc; a != NIL; a = as[a].suc ) {
+      vs[as[a].node].d--;
+      AdjNode& b = as[as[a].pos];
+      as[b.pre].suc = b.suc;
+      if ( b.suc != NIL )
+	as[b.suc].pre = b.pre;
+    }
+  }
+
+  /// U becomes the new P, in O(1): its vertices carry the next class stamp
+  template <bool counted>
+  void swap ( void ) {
+    vs[P].suc = vs[U].suc;
+    if ( vs[P].suc != NIL )
+      vs[vs[P].suc].pre = P;
+    vs[U].suc = NIL;
+    vs[U].pre = U;
+    epoch++;
+  }
+
+private:
+  struct AdjNode {
+    Index node;   /// Adjacent vertex
+    Index pos;    /// Position of the copy of this node in the list of the other vertex
+    Index suc;
+    Index pre;
+  };
+
+  struct Vertex {
+    Vertex ( void ) : d(0), c(0), as(0), u(0), pe(1), suc(NIL), pre(NIL) {}
+    Index d;      /// Degree of the vertex in the residual graph
+    Color c;      /// Color of the vertex
+    Index as;     /// Head of the adjacency list
+    Index u;      /// Degree of the vertex induced by U (vertices in P only)
+    uint32_t pe;  /// Class whose P holds the vertex (0: colored)
+    Index suc;    /// Successor vertex in the P or U list
+    Index pre;    /// Predecessor vertex in the P or U list
+  };
+
+  inline void skip ( Index w ) {
+    vs[vs[w].pre].suc = vs[w].suc;
+    if ( vs[w].suc != NIL )
+      vs[vs[w].suc].pre = vs[w].pre;
+  }
+
+  Index           n;
+  Index           P;    /// Head of the P list
+  Index           U;    /// Head of the U list (its 'pre' is the tail)
+  uint32_t        epoch;  /// Class being built
+  vector<Vertex>  vs;
+  vector<AdjNode> as;
+};
+
+///------------------------------------------------------------------------------------------
+/// Neighborhood operations of the engine, written on the adjacency iterators
+/// of the layout. A layout that does not store the edges (ComplementLayout)
+/// overloads them.
+
+/// Move N(v) ∩ P to the back of U, in adjacency order; if 'counted', every
+/// neighbor of a moved vertex gains one degree to U
+template <bool counted, class L, class Index>
+inline void move_neighbors_to_u ( L& G, Index v ) {
+  for ( typename L::AdjIter w = G.adj( v ); w(); ++w ) {
+    Index pw = w.node();
+    if ( G.inP( pw ) ) {
+      /// Update degree to U for all neighbors of pw
+      if ( counted )
+	for ( typename L::AdjIter u = G.adj( pw ); u(); ++u )
+	  G.incU( u.node() );
+      G.moveToU( pw );
+    }
+  }
+}
+
+/// |N(v) ∩ P|
+template <class L, class Index>
+inline Index degree_to_p ( L& G, Index v ) {
+  Index dp = 0;
+  for ( typename L::AdjIter u = G.adj( v ); u(); ++u )
+    dp += G.inP( u.node() );
+  return dp;
+}
+
+/// |N(w) ∩ U|, computed only as long as it can reach du_max (lower otherwise)
+template <class L, class Index>
+inline Index degree_to_u ( L& G, Index w, Index du_max ) {
+  Index d = G.degree( w );
+  if ( d < du_max )
+    return 0;
+  Index du = d;
+  for ( typename L::AdjIter u = G.adj( w ); u(); ++u ) {
+    du -= G.inP( u.node() );
+    if ( du < du_max )
+      return du;
+  }
+  return du;
+}
+
+///------------------------------------------------------------------------------------------
+template <class Selection, class DegreeToU, template <class> class Layout, class Index>
+class RlfEngine {
+public:
+  typedef Layout<Index>              L;
+  typedef typename L::PIter          PIter;
+
+  RlfEngine ( const CsrGraph& g, const Options& opt0 )
+    : G(g, opt0), opt(opt0), rng(opt0.seed), nv(g.n), me(g.m), stopped(false) {}
+
+  /// Color the graph, return the number of colors (0 if the graph is too large)
+  static Color color ( const CsrGraph& g, const Options& opt, vector<Color>& colors ) {
+    if ( !L::fits( g ) )
+      return 0;
+    RlfEngine E( g, opt );
+    Color k = E.run();
+    colors.resize( g.n );
+    for ( Index v = 0; v < g.n; v++ )
+      colors[v] = E.G.color( v );
+    if ( E.stopped )
+      k = first_fit( g, colors );
+    return k;
+  }
+
+  Color run ( void ) {
+    Color c = 0;
+    unsigned int l = nv;
+    do {
+      c++; /// Open new class of color
+      l -= Selection::template color_class<DegreeToU>( *this, c, opt );
+    } while ( l > 0 && !stopped );
+    return stopped ? c-1 : c;
+  }
+
+  /// Density of the residual graph
+  double density ( void ) const {
+    double n = double(nv);
+    double m = double(me);
+    return m/(n*(n-1)/2.0);
+  }
+
+  /// Color an independent set with 'color'
+  template <class D>
+  unsigned int new_color_class ( Color color ) {
+    /// Anytime runs: stop at the deadline, or when the class cannot beat the cutoff
+    if ( ( opt.cutoff > 0 && color > opt.cutoff ) ||
+	 ( opt.deadline > 0 && clock_ns() >= opt.deadline ) ) {
+      stopped = true;
+      return 0;
+    }
+    /// Select the first vertex
+    Index v = G.maxDegree( rng );
+    /// Color the selected vertex
+    G.setColor( v, color );
+    /// Move delta(v) from V to U
+    moveNeighbors<D::counted>( v );
+
+    /// Size of the stable set
+    unsigned int size = 1;
+    while ( !G.empty() ) {
+      /// Select an uncolored vertex from G
+      v = D::counted ? G.argmaxU() : selectScanned();
+      /// Color the selected vertex
+      G.setColor( v, color );
+      /// Move delta(v) from V to U; remove v from G and P
+      moveNeighbors<D::counted>( v );
+      size++;
+    }
+
+    /// Swap the set V and U
+    G.template swap<D::counted>();
+    return size;
+  }
+
+private:
+  /// Lazy selection: start from a vertex of maximum degree, then scan P
+  Index selectScanned ( void ) {
+    Index v = G.maxDegree( rng );
+    Index du_max = degree_to_p( G, v );
+
+    /// A vertex of degree lower than du_max cannot be selected
+    PIter w = G.pIter();
+    for ( w.seek( du_max ); w(); ++w, w.seek( du_max ) ) {
+      Index pw = *w;
+      Index du = degree_to_u( G, pw, du_max );
+      /// Select vertex with maximum degree induced by U, break ties...
+      if ( du > du_max || (du == du_max && G.degree(pw) < G.degree(v)) ) {
+	du_max = du;
+	v      = pw;
+      }
+    }
+    return v;
+  }
+
+  /// Move delta(v) from P to U, then remove v from G and P
+  template <bool counted>
+  void moveNeighbors ( Index v ) {
+    move_neighbors_to_u<counted>( G, v );
+    nv--;
+    me -= G.degree( v );
+    G.clearVertex( v );
+    G.removeFromP( v );
+  }
+
+  L            G;
+  Options      opt;
+  Random       rng;
+  unsigned int nv;    /// Vertices of the residual graph
+  uint64_t     me;    /// Edges of the residual graph
+  bool         stopped;  /// Stopped by the deadline or the cutoff
+};
+
+} // namespace rlf
+
+#endif
@@ -0,0 +1,258 @@
+#ifndef _MY_RLF_HYBRID_
+#define _MY_RLF_HYBRID_
+
+#include "rlf_soa.hpp"
+
+namespace rlf {
+
+///------------------------------------------------------------------------------------------
+/// Structure of arrays layout with a representation per vertex: the vertices
+/// of degree at least n/HYBRID_RATIO (hubs), whose bitset row is not larger
+/// than their list, keep their neighbors as a row of n bits; the others keep
+/// their sorted list. P and U are also kept as bitsets, beside the stamps.
+///
+/// The neighborhood operations dispatch on the representation of the vertex:
+///
+///   list   x  P, U stamps :  walk the list, test every entry
+///   bitset x  P, U bitsets:  AND the words, popcount (|N(w) ∩ U|, |N(v) ∩ P|)
+///                            or walk the set bits (N(v) ∩ P)
+///
+/// Bits are walked in increasing order, as the sorted lists, so the colorings
+/// are the same as with SoALayout.
+static const uint32_t HYBRID_RATIO = 32;
+/// Words of a row counted between two checks of the degree to U bound
+static const size_t   HYBRID_WORDS = 64;
+
+template <class Index>
+class HybridLayout : public SoALayout<Index> {
+public:
+  typedef SoALayout<Index>         Base;
+  typedef typename Base::AdjIter   ListIter;   /// Lists only, without the dispatch
+
+  static bool fits ( const CsrGraph& g ) { return Base::fits( g ); }
+
+  HybridLayout ( const CsrGraph& g, const Options& opt )
+    : Base( g, opt, false ), W((g.n+63)/64), row(g.n, NONE), pb(W, 0), ub(W, 0), hubs(0) {
+    Index hub = Index( ( g.n + HYBRID_RATIO - 1 ) / HYBRID_RATIO );
+    if ( hub < 64 )
+      hub = 64;
+    size_t entries = 0;
+    for ( Index v = 0; v < this->n; v++ )
+      if ( g.degree( v ) >= hub )
+	row[v] = hubs++;
+      else
+	entries += g.degree( v );
+    bits.assign( size_t(hubs) * W, 0 );
+    this->nb.reserve( entries );
+    for ( Index v = 0; v < this->n; v++ ) {
+      this->start[v] = Index( this->nb.size() );
+      pb[v/64] |= uint64_t(1) << ( v%64 );
+      if ( row[v] != NONE ) {
+	uint64_t* r = &bits[size_t(row[v]) * W];
+	for ( uint64_t p = g.off[v]; p < g.off[v+1]; p++ )
+	  r[g.adj[p]/64] |= uint64_t(1) << ( g.adj[p]%64 );
+	this->len[v] = 0;
+      } else
+	this->nb.insert( this->nb.end(), g.adj + g.off[v], g.adj + g.off[v+1] );
+    }
+  }
+
+  ///--------------------------------------------------
+  /// Iterator over the live neighbors of a vertex: the list entries not
+  /// colored, or the bits of the row also set in P or U
+  class AdjIter {
+  public:
+    AdjIter ( const Index* a0, const Index* e0, const unsigned char* alive0 )
+      : a(a0), e(e0), alive(alive0), r(NULL), done(false) { ++*this; }
+    AdjIter ( const uint64_t* r0, const uint64_t* p0, const uint64_t* q0, size_t W0 )
+      : a(NULL), e(NULL), alive(NULL), r(r0), p(p0), q(q0), i(0), W(W0), done(false) {
+      x = ( W > 0 ) ? r[0] & ( p[0] | q[0] ) : 0;
+      ++*this;
+    }
+    inline bool  operator()() const { return !done; }
+    inline Index node      () const { return cur; }
+    inline void  operator++() {
+      if ( r == NULL ) {
+	while ( a != e && !alive[*a] )
+	  ++a;
+	if ( a == e )
+	  done = true;
+	else
+	  cur = *a++;
+	return;
+      }
+      while ( x == 0 ) {
+	if ( ++i >= W ) {
+	  done = true;
+	  return;
+	}
+	x = r[i] & ( p[i] | q[i] );
+      }
+      cur = Index( i*64 + __builtin_ctzll( x ) );
+      x  &= x - 1;
+    }
+  private:
+    const Index*         a;
+    const Index*         e;
+    const unsigned char* alive;
+    const uint64_t*      r;
+    const uint64_t*      p;
+    const uint64_t*      q;
+    size_t               i;
+    size_t               W;
+    uint64_t             x;    /// Bits of word i not walked yet
+    Index                cur;
+    bool                 done;
+  };
+
+  inline AdjIter adj ( Index v ) {
+    if ( row[v] != NONE )
+      return AdjIter( rowOf( v ), &pb[0], &ub[0], W );
+    if ( this->len[v] > this->d[v] + this->d[v]/4 + 8 )
+      this->compact( v );
+    const Index* a = &this->nb[0] + this->start[v];
+    return AdjIter( a, a + this->len[v], &this->alive[0] );
+  }
+
+  inline bool hub ( Index v ) const { return row[v] != NONE; }
+
+  inline void moveToU ( Index w ) {
+    Base::moveToU( w );
+    pb[w/64] &= ~( uint64_t(1) << ( w%64 ) );
+    ub[w/64] |=    uint64_t(1) << ( w%64 );
+  }
+
+  inline void removeFromP ( Index v ) {
+    Base::removeFromP( v );
+    pb[v/64] &= ~( uint64_t(1) << ( v%64 ) );
+  }
+
+  inline void clearVertex ( Index v ) {
+    for ( AdjIter w = adj( v ); w(); ++w )
+      this->d[w.node()]--;
+    this->alive[v] = 0;
+  }
+
+  /// P is empty at the end of a class: its bitset is the new, empty, U
+  template <bool counted>
+  void swap ( void ) {
+    Base::template swap<counted>();
+    pb.swap( ub );
+  }
+
+  ///--------------------------------------------------
+  /// Neighborhood operations of the engine (see rlf_engine.hpp)
+
+  template <bool counted>
+  void moveNeighborsToU ( Index v ) {
+    if ( row[v] == NONE ) {
+      for ( ListIter w = Base::adj( v ); w(); ++w ) {
+	Index pw = w.node();
+	if ( this->inP( pw ) ) {
+	  if ( counted )
+	    incNeighborsInP( pw );
+	  moveToU( pw );
+	}
+      }
+      return;
+    }
+    const uint64_t* r = rowOf( v );
+    for ( size_t i = 0; i < W; i++ )
+      for ( uint64_t x = r[i] & pb[i]; x != 0; x &= x - 1 ) {
+	Index pw = Index( i*64 + __builtin_ctzll( x ) );
+	if ( counted )
+	  incNeighborsInP( pw );
+	moveToU( pw );
+      }
+  }
+
+  Index degreeToP ( Index v ) {
+    if ( row[v] == NONE ) {
+      Index dp = 0;
+      for ( ListIter u = Base::adj( v ); u(); ++u )
+	dp += this->inP( u.node() );
+      return dp;
+    }
+    return count( rowOf( v ), &pb[0] );
+  }
+
+  Index degreeToU ( Index w, Index du_max ) {
+    Index d = this->d[w];
+    if ( d < du_max )
+      return 0;
+    Index du = d;
+    if ( row[w] != NONE ) {
+      /// The live neighbors not in P are in U: stop as the lists do
+      const uint64_t* r = rowOf( w );
+      for ( size_t i = 0; i < W; i += HYBRID_WORDS ) {
+	du -= Index( simd::and_count( r + i, &pb[i], ( W - i < HYBRID_WORDS ) ? W - i : HYBRID_WORDS ) );
+	if ( du < du_max )
+	  return du;
+      }
+      return du;
+    }
+    for ( ListIter u = Base::adj( w ); u(); ++u ) {
+      du -= this->inP( u.node() );
+      if ( du < du_max )
+	return du;
+    }
+    return du;
+  }
+
+  /// Hubs and the bytes of their rows
+  Index    hubCount  ( void ) const { return hubs; }
+  uint64_t hubBytes  ( void ) const { return uint64_t( bits.size() ) * sizeof(uint64_t); }
+
+private:
+  static const Index NONE = Index(-1);
+
+  inline const uint64_t* rowOf ( Index v ) const { return &bits[size_t(row[v]) * W]; }
+
+  /// |r ∩ s| on W words
+  inline Index count ( const uint64_t* r, const uint64_t* s ) const {
+    return Index( simd::and_count( r, s, W ) );
+  }
+
+  /// Every neighbor of w in P gains one degree to U
+  inline void incNeighborsInP ( Index w ) {
+    if ( row[w] == NONE ) {
+      for ( ListIter x = Base::adj( w ); x(); ++x )
+	this->incU( x.node() );
+      return;
+    }
+    const uint64_t* r = rowOf( w );
+    for ( size_t i = 0; i < W; i++ )
+      for ( uint64_t x = r[i] & pb[i]; x != 0; x &= x - 1 )
+	this->u[i*64 + __builtin_ctzll( x )]++;
+  }
+
+  size_t                W;      /// Words of a bitset
+  GraphVector<Index>    row;    /// Row of every hub in bits (NONE: list)
+  GraphVector<uint64_t> bits;   /// Neighbor rows of the hubs
+  GraphVector<uint64_t> pb;     /// P, one bit per vertex
+  GraphVector<uint64_t> ub;     /// U, one bit per vertex
+  Index                 hubs;
+};
+
+/// Bound to a reference by the vector constructor: needs a definition
+template <class Index>
+const Index HybridLayout<Index>::NONE;
+
+template <bool counted, class Index>
+inline void move_neighbors_to_u ( HybridLayout<Index>& G, Index v ) {
+  G.template moveNeighborsToU<counted>( v );
+}
+
+template <class Index>
+inline Index degree_to_p ( HybridLayout<Index>& G, Index v ) {
+  return G.degreeToP( v );
+}
+
+template <class Index>
+inline Index degree_to_u ( HybridLayout<Index>& G, Index w, Index du_max ) {
+  return G.degreeToU( w, du_max );
+}
+
+} // namespace rlf
+
+#endif
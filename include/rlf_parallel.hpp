@@ -0,0 +1,106 @@
+#ifndef _MY_RLF_PARALLEL_
+#define _MY_RLF_PARALLEL_
+
+#include "rlf_soa.hpp"
+#include "thread_pool.hpp"
+
+namespace rlf {
+
+///------------------------------------------------------------------------------------------
+/// Structure of arrays layout whose heavy steps are shared by Options::threads
+/// threads, with the same coloring as one thread:
+///
+///  * the neighbors of the selected vertex leave P first, in order, then the
+///    degrees to U they cause are counted by all threads (atomic increments on
+///    the vertices still in P, whose final counts do not depend on the order);
+///  * the scan for the maximum degree to U is split in slices of P, and the
+///    first maximum of the first slice holding one is kept, as in one pass.
+///
+/// A step with less than PARALLEL_MIN_WORK adjacency entries (or P entries)
+/// runs in the calling thread. The vertices of maximum degree and the random
+/// tie breaks stay sequential.
+static const size_t PARALLEL_MIN_WORK = size_t(1) << 16;
+
+template <class Index>
+class ParallelSoALayout : public SoALayout<Index> {
+public:
+  typedef SoALayout<Index>          Base;
+  typedef typename Base::AdjIter    AdjIter;
+
+  ParallelSoALayout ( const CsrGraph& g, const Options& opt ) : Base( g, opt ), team( opt.threads ) {}
+
+  /// Vertex of P with maximum degree to U, ties broken by minimum degree
+  Index argmaxU ( void ) {
+    this->compactP();
+    size_t k = this->P.size();
+    unsigned int T = team.size();
+    if ( T == 1 || k < PARALLEL_MIN_WORK )
+      return Base::argmaxU();
+
+    const Index* P = &this->P[0];
+    const Index* u = &this->u[0];
+    const Index* d = &this->d[0];
+    bool vec = this->vec;
+    vector<size_t> best( T );
+    team.run( [&] ( unsigned int t ) {
+	size_t a = k * t / T, b = k * (t+1) / T;
+	best[t] = a + ( vec ? simd::argmax_hi_lo( P+a, b-a, u, d )
+			    : simd::argmax_hi_lo<Index>( P+a, b-a, u, d ) );
+      } );
+    size_t i = best[0];
+    for ( unsigned int t = 1; t < T; t++ ) {
+      Index w = P[best[t]], v = P[i];
+      if ( u[w] > u[v] || ( u[w] == u[v] && d[w] < d[v] ) )
+	i = best[t];
+    }
+    return P[i];
+  }
+
+  /// Move N(v) ∩ P to U (see move_neighbors_to_u)
+  template <bool counted>
+  void moveNeighborsToU ( Index v ) {
+    moved.clear();
+    size_t work = 0;
+    for ( AdjIter w = this->adj( v ); w(); ++w )
+      if ( this->inP( w.node() ) ) {
+	moved.push_back( w.node() );
+	work += this->len[w.node()];
+      }
+    if ( !counted || team.size() == 1 || work < PARALLEL_MIN_WORK ) {
+      for ( size_t i = 0; i < moved.size(); i++ ) {
+	if ( counted )
+	  for ( AdjIter x = this->adj( moved[i] ); x(); ++x )
+	    this->incU( x.node() );
+	this->moveToU( moved[i] );
+      }
+      return;
+    }
+
+    for ( size_t i = 0; i < moved.size(); i++ )
+      this->moveToU( moved[i] );
+    /// Every thread walks its own lists (compacting only those)
+    unsigned int    T     = team.size();
+    Index*          u     = &this->u[0];
+    const uint32_t* pe    = &this->pe[0];
+    uint32_t        epoch = this->epoch;
+    team.run( [&] ( unsigned int t ) {
+	for ( size_t i = t; i < moved.size(); i += T )
+	  for ( AdjIter x = this->adj( moved[i] ); x(); ++x )
+	    if ( pe[x.node()] == epoch )
+	      __atomic_fetch_add( &u[x.node()], 1, __ATOMIC_RELAXED );
+      } );
+  }
+
+private:
+  WorkTeam      team;
+  vector<Index> moved;
+};
+
+template <bool counted, class Index>
+inline void move_neighbors_to_u ( ParallelSoALayout<Index>& G, Index v ) {
+  G.template moveNeighborsToU<counted>( v );
+}
+
+} // namespace rlf
+
+#endif
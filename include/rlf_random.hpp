@@ -0,0 +1,45 @@
+#ifndef _MY_RLF_RANDOM_
+#define _MY_RLF_RANDOM_
+
+#include <cstdlib>
+#include <cstring>
+
+/// For short integers
+#include <stdint.h>
+
+///------------------------------------------------------------------------------------------
+/// Reentrant random generator for the tie breaking of the engines.
+/// It draws the same sequence as srand(seed)/rand(), but every run owns its
+/// state, so that several colorings can run at the same time.
+class Random {
+public:
+  explicit Random ( unsigned int seed ) {
+    memset( &data, 0, sizeof(data) );
+    initstate_r( seed, (char*)state, sizeof(state), &data );
+  }
+
+  /// The copy goes on with the same sequence: the pointers of random_r are
+  /// moved to its own state
+  Random ( const Random& r ) { *this = r; }
+  Random& operator= ( const Random& r ) {
+    memcpy( state, r.state, sizeof(state) );
+    data         = r.data;
+    data.fptr    = state + ( r.data.fptr    - r.state );
+    data.rptr    = state + ( r.data.rptr    - r.state );
+    data.state   = state + ( r.data.state   - r.state );
+    data.end_ptr = state + ( r.data.end_ptr - r.state );
+    return *this;
+  }
+
+  inline int operator()() {
+    int32_t r;
+    random_r( &data, &r );
+    return r;
+  }
+
+private:
+  int32_t            state[32];
+  struct random_data data;
+};
+
+#endif
@@ -0,0 +1,79 @@
+#ifndef _MY_RLF_SIMD_
+#define _MY_RLF_SIMD_
+
+#include <cstddef>
+#include <stdint.h>
+
+///------------------------------------------------------------------------------------------
+/// Vectorized scans over the P index array of SoALayout.
+///
+/// Every kernel reads val[idx[i]] for the positions i of a range of the index
+/// array (a gather), and has a scalar version for any index type. The
+/// uint32_t versions dispatch at run time to AVX-512, AVX2 or the scalar code,
+/// according to the CPU; the environment variable RLF_SIMD (scalar, avx2,
+/// avx512) caps the level. The indices must be lower than 2^31.
+///------------------------------------------------------------------------------------------
+
+namespace rlf {
+namespace simd {
+
+  enum Level { SCALAR = 0, AVX2, AVX512 };
+
+  /// Level used by the kernels
+  Level       level      ( void );
+  const char* level_name ( Level l );
+
+  /// First position i in [i0,k) with val[idx[i]] >= t; k if none
+  template <class Index>
+  inline size_t find_ge ( const Index* idx, size_t i0, size_t k, const Index* val, Index t ) {
+    for ( size_t i = i0; i < k; i++ )
+      if ( val[idx[i]] >= t )
+	return i;
+    return k;
+  }
+
+  /// First position of the maximum of the key (hi[idx[i]], -lo[idx[i]]) over [0,k), k > 0:
+  /// maximum hi, ties broken by minimum lo, then by minimum position
+  template <class Index>
+  inline size_t argmax_hi_lo ( const Index* idx, size_t k, const Index* hi, const Index* lo ) {
+    size_t b = 0;
+    for ( size_t i = 1; i < k; i++ ) {
+      Index w = idx[i];
+      Index v = idx[b];
+      if ( ( hi[w] > hi[v] ) ||
+	   ( hi[w] == hi[v] && lo[w] < lo[v] ) )
+	b = i;
+    }
+    return b;
+  }
+
+  size_t find_ge      ( const uint32_t* idx, size_t i0, size_t k, const uint32_t* val, uint32_t t );
+  size_t argmax_hi_lo ( const uint32_t* idx, size_t k, const uint32_t* hi, const uint32_t* lo );
+
+  ///--------------------------------------------------
+  /// Gap lists in the StreamVByte format: every value is stored on 1 to 4
+  /// bytes of a data stream, its length minus one on 2 bits of a control
+  /// stream (4 values per control byte, the first in the low bits), and the
+  /// values are the gaps between consecutive entries of a sorted list.
+  /// Decoding runs 4 values per byte shuffle (SSSE3) from the AVX2 level up.
+
+  /// Encode the sorted values in[0..k), the first as a gap from 0: (k+3)/4
+  /// control bytes go to ctrl; return the number of data bytes written
+  size_t encode_gaps ( const uint32_t* in, size_t k, unsigned char* ctrl, unsigned char* data );
+
+  /// Decode k values, adding the gaps up from 'prev'; return the number of
+  /// data bytes read. The data is read up to 16 bytes past its end.
+  size_t decode_gaps ( const unsigned char* ctrl, const unsigned char* data, size_t k,
+		       uint32_t prev, uint32_t* out );
+
+  ///--------------------------------------------------
+  /// Bitsets
+
+  /// Bits set in both a and b, over w words. The POPCNT instruction is used
+  /// from the AVX2 level up.
+  uint64_t and_count ( const uint64_t* a, const uint64_t* b, size_t w );
+
+} // namespace simd
+} // namespace rlf
+
+#endif
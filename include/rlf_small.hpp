@@ -0,0 +1,281 @@
+#ifndef _MY_RLF_SMALL_
+#define _MY_RLF_SMALL_
+
+#include "rlf_engine.hpp"
+
+namespace rlf {
+
+/// Largest graph colored by SmallEngine
+static const uint32_t SMALL_MAX = 512;
+
+///------------------------------------------------------------------------------------------
+/// RLF engine for graphs of at most 64*W vertices, W fixed at compile time.
+/// The whole state is one object on the stack: the adjacency matrix as rows
+/// of W words, P, U and the uncolored vertices as bitsets, and the degrees
+/// and the P/U orders as 16-bit arrays. Nothing is allocated.
+///
+/// Neighborhoods are ANDs of a row with a set: N(v) ∩ P is walked by its set
+/// bits, |N(w) ∩ U| is a popcount over W words. The engine runs the classes
+/// of RlfEngine under the same policies, walking the bits in increasing order
+/// (the order of the sorted lists) and keeping P in the order of the moves,
+/// so the colorings are the same as with the other layouts.
+template <unsigned W, class Selection, class DegreeToU>
+class SmallEngine {
+public:
+  static const unsigned N = 64*W;
+  typedef uint16_t Index;
+
+  /// Color the graph of n <= N vertices given as CSR arrays (sorted or not,
+  /// self loops and duplicated entries ignored) into colors[0..n), return
+  /// the number of colors
+  static Color color ( uint32_t n, const uint64_t* off, const uint32_t* adj, const Options& opt,
+		       Color* colors ) {
+    SmallEngine E( n, off, adj, opt, colors );
+    Color k = E.run();
+    if ( E.stopped )
+      k = E.firstFit();
+    return k;
+  }
+
+  Color run ( void ) {
+    Color c = 0;
+    unsigned int l = nv;
+    do {
+      c++; /// Open new class of color
+      l -= Selection::template color_class<DegreeToU>( *this, c, opt );
+    } while ( l > 0 && !stopped );
+    return stopped ? c-1 : c;
+  }
+
+  /// Density of the residual graph
+  double density ( void ) const {
+    double n0 = double(nv);
+    double m0 = double(me);
+    return m0/(n0*(n0-1)/2.0);
+  }
+
+  /// Color an independent set with 'color' (as RlfEngine::new_color_class)
+  template <class D>
+  unsigned int new_color_class ( Color color ) {
+    if ( ( opt.cutoff > 0 && color > opt.cutoff ) ||
+	 ( opt.deadline > 0 && clock_ns() >= opt.deadline ) ) {
+      stopped = true;
+      return 0;
+    }
+    Index v = maxDegree();
+    c[v] = color;
+    moveNeighbors<D::counted>( v );
+
+    unsigned int size = 1;
+    while ( pLive > 0 ) {
+      v = D::counted ? argmaxU() : selectScanned();
+      c[v] = color;
+      moveNeighbors<D::counted>( v );
+      size++;
+    }
+
+    /// U becomes P, in the order of the moves
+    Index* t = pa;  pa = ua;  ua = t;
+    pk = uk;
+    uk = 0;
+    pLive = pk;
+    for ( unsigned i = 0; i < W; i++ ) {
+      pb[i] = ub[i];
+      ub[i] = 0;
+    }
+    return size;
+  }
+
+private:
+  SmallEngine ( uint32_t n0, const uint64_t* off, const uint32_t* adj, const Options& opt0, Color* c0 )
+    : opt(opt0), rng(opt0.seed), c(c0), n(n0), pa(pbuf), ua(ubuf), pk(n0), uk(0), pLive(n0),
+      nv(n0), me(0), stopped(false) {
+    for ( unsigned i = 0; i < W; i++ )
+      pb[i] = ub[i] = 0;
+    for ( Index v = 0; v < n; v++ ) {
+      uint64_t* r = row[v];
+      for ( unsigned i = 0; i < W; i++ )
+	r[i] = 0;
+      for ( uint64_t p = off[v]; p < off[v+1]; p++ )
+	r[adj[p] >> 6] |= uint64_t(1) << ( adj[p] & 63 );
+      /// A self loop would move v to U from its own row
+      r[v >> 6] &= ~( uint64_t(1) << ( v & 63 ) );
+      d[v] = Index( count( r, r ) );
+      u[v] = 0;
+      c[v] = 0;
+      pa[v] = v;
+      pb[v >> 6] |= uint64_t(1) << ( v & 63 );
+      me += d[v];
+    }
+    me /= 2;
+    for ( unsigned i = 0; i < W; i++ )
+      live[i] = pb[i];
+  }
+
+  inline bool inP ( Index v ) const { return pb[v >> 6] >> ( v & 63 ) & 1; }
+
+  /// |r ∩ s|
+  static inline unsigned count ( const uint64_t* r, const uint64_t* s ) {
+    unsigned k = 0;
+    for ( unsigned i = 0; i < W; i++ )
+      k += __builtin_popcountll( r[i] & s[i] );
+    return k;
+  }
+
+  /// Drop the vertices no longer in P from the P order
+  inline void compactP ( void ) {
+    unsigned k = 0;
+    for ( unsigned i = 0; i < pk; i++ )
+      if ( inP( pa[i] ) )
+	pa[k++] = pa[i];
+    pk = k;
+  }
+
+  /// Vertex of P with maximum degree, ties broken at random
+  Index maxDegree ( void ) {
+    compactP();
+    Index v = pa[0];
+    for ( unsigned i = 1; i < pk; i++ ) {
+      Index w = pa[i];
+      if ( ( d[w] > d[v] ) ||
+	   ( d[w] == d[v] && rng()%2 ) )
+	v = w;
+    }
+    return v;
+  }
+
+  /// Vertex of P with maximum degree to U, ties broken by minimum degree
+  Index argmaxU ( void ) {
+    compactP();
+    Index v = pa[0];
+    for ( unsigned i = 1; i < pk; i++ ) {
+      Index w = pa[i];
+      if ( ( u[w] > u[v] ) ||
+	   ( u[w] == u[v] && d[w] < d[v] ) )
+	v = w;
+    }
+    return v;
+  }
+
+  /// Lazy selection: start from a vertex of maximum degree, then scan P
+  Index selectScanned ( void ) {
+    Index    v = maxDegree();
+    unsigned du_max = count( row[v], pb );
+    for ( unsigned i = 0; i < pk; i++ ) {
+      Index w = pa[i];
+      if ( d[w] < du_max || !inP( w ) )
+	continue;
+      unsigned du = count( row[w], ub );
+      if ( du > du_max || ( du == du_max && d[w] < d[v] ) ) {
+	du_max = du;
+	v      = w;
+      }
+    }
+    return v;
+  }
+
+  /// Move N(v) ∩ P to the back of U, then remove v from the graph and P
+  template <bool counted>
+  void moveNeighbors ( Index v ) {
+    const uint64_t* r = row[v];
+    for ( unsigned i = 0; i < W; i++ )
+      for ( uint64_t x = r[i] & pb[i]; x != 0; x &= x - 1 ) {
+	Index pw = Index( i*64 + __builtin_ctzll( x ) );
+	if ( counted ) {
+	  const uint64_t* s = row[pw];
+	  for ( unsigned j = 0; j < W; j++ )
+	    for ( uint64_t y = s[j] & pb[j]; y != 0; y &= y - 1 )
+	      u[j*64 + __builtin_ctzll( y )]++;
+	}
+	pb[i] &= ~( uint64_t(1) << ( pw & 63 ) );
+	ub[i] |=    uint64_t(1) << ( pw & 63 );
+	u[pw] = 0;
+	ua[uk++] = pw;
+	pLive--;
+      }
+    nv--;
+    me -= d[v];
+    for ( unsigned i = 0; i < W; i++ )
+      for ( uint64_t x = r[i] & live[i]; x != 0; x &= x - 1 )
+	d[i*64 + __builtin_ctzll( x )]--;
+    live[v >> 6] &= ~( uint64_t(1) << ( v & 63 ) );
+    pb[v >> 6]   &= ~( uint64_t(1) << ( v & 63 ) );
+    pLive--;
+  }
+
+  /// Vertices left by a stopped run take the smallest color free around them
+  Color firstFit ( void ) {
+    Color k = 0;
+    for ( Index v = 0; v < n; v++ )
+      if ( c[v] > k )
+	k = c[v];
+    uint64_t used[W+1];
+    for ( Index v = 0; v < n; v++ ) {
+      if ( c[v] != 0 )
+	continue;
+      for ( unsigned i = 0; i <= W; i++ )
+	used[i] = 0;
+      for ( unsigned i = 0; i < W; i++ )
+	for ( uint64_t x = row[v][i]; x != 0; x &= x - 1 ) {
+	  Color cw = c[i*64 + __builtin_ctzll( x )];
+	  used[cw >> 6] |= uint64_t(1) << ( cw & 63 );
+	}
+      Color cv = 1;
+      while ( used[cv >> 6] >> ( cv & 63 ) & 1 )
+	cv++;
+      c[v] = cv;
+      if ( cv > k )
+	k = cv;
+    }
+    return k;
+  }
+
+  const Options& opt;
+  Random         rng;
+  Color*         c;
+  Index          n;
+  uint64_t       row[N][W];   /// Adjacency matrix (rows of the first n vertices)
+  uint64_t       pb[W];       /// P
+  uint64_t       ub[W];       /// U
+  uint64_t       live[W];     /// Uncolored vertices
+  Index          d[N];        /// Degree in the residual graph
+  Index          u[N];        /// Degree induced by U (vertices in P only)
+  Index          pbuf[N];
+  Index          ubuf[N];
+  Index*         pa;          /// P in order (with the vertices that left it until compacted)
+  Index*         ua;          /// U in order of the moves
+  unsigned       pk;
+  unsigned       uk;
+  unsigned       pLive;       /// Vertices in P
+  unsigned int   nv;          /// Vertices of the residual graph
+  uint64_t       me;          /// Edges of the residual graph
+  bool           stopped;     /// Stopped by the deadline or the cutoff
+};
+
+/// Color a graph of at most SMALL_MAX vertices with the SmallEngine of the
+/// smallest size that holds it; 0 if the graph is larger (or empty)
+template <class Selection, class DegreeToU>
+inline Color color_small ( uint32_t n, const uint64_t* off, const uint32_t* adj, const Options& opt,
+			   Color* colors ) {
+  if ( n == 0 )
+    return 0;
+  if ( n <= 64 )
+    return SmallEngine< 1, Selection, DegreeToU >::color( n, off, adj, opt, colors );
+  if ( n <= 128 )
+    return SmallEngine< 2, Selection, DegreeToU >::color( n, off, adj, opt, colors );
+  if ( n <= 256 )
+    return SmallEngine< 4, Selection, DegreeToU >::color( n, off, adj, opt, colors );
+  if ( n <= 512 )
+    return SmallEngine< 8, Selection, DegreeToU >::color( n, off, adj, opt, colors );
+  return 0;
+}
+
+template <class Selection, class DegreeToU>
+inline Color color_small ( const CsrGraph& g, const Options& opt, vector<Color>& colors ) {
+  colors.resize( g.n );
+  return color_small<Selection, DegreeToU>( g.n, g.off, g.adj, opt, colors.empty() ? NULL : &colors[0] );
+}
+
+} // namespace rlf
+
+#endif
@@ -0,0 +1,214 @@
+#ifndef _MY_RLF_SOA_
+#define _MY_RLF_SOA_
+
+#include <climits>
+
+#include "rlf_engine.hpp"
+#include "rlf_simd.hpp"
+
+namespace rlf {
+
+///------------------------------------------------------------------------------------------
+/// Structure of arrays layout: degree, degree to U, P flags and colors are
+/// separate dense arrays indexed by vertex, and P and U are compact arrays of
+/// vertex indices, so that the selection scans read contiguous 32-bit values.
+///
+/// Nothing is unlinked when a vertex is colored: the vertex is flagged dead and
+/// skipped by the adjacency iterators; a list is compacted (in order) once a
+/// fifth of its entries are dead. Vertices leaving P are dropped from
+/// the P array at the next scan. Orders are preserved everywhere, so the
+/// colorings are the same as with LinkedLayout.
+///
+/// Membership in P is a stamp compared with the class number: a vertex moved
+/// to U is stamped with the next class, so swapping U in as the new P only
+/// bumps the class number; degrees to U count only the vertices still in P
+/// and restart from 0 when a vertex leaves P, so nothing is reset either.
+///
+/// The scans over P run the kernels of rlf_simd.hpp (vectorized for uint32_t
+/// indices, up to 2^31 vertices).
+template <class Index>
+class SoALayout {
+public:
+  static const Index NIL = Index(-1);
+
+  static bool fits ( const CsrGraph& g ) {
+    return uint64_t(g.n) < NIL && 2*g.m < NIL;
+  }
+
+  /// Without 'lists' the neighbors are not copied (a derived layout stores them)
+  SoALayout ( const CsrGraph& g, const Options&, bool lists = true )
+    : n(g.n), start(g.n), len(g.n), nb(g.adj, g.adj + ( lists ? 2*g.m : 0 )), d(g.n), u(g.n, 0),
+      pe(g.n, 1), epoch(1), alive(g.n, 1), c(g.n, 0), P(g.n), pLive(g.n), pDead(0),
+      vec(uint64_t(g.n) <= INT_MAX) {
+    for ( Index v = 0; v < n; v++ ) {
+      start[v] = Index(g.off[v]);
+      len[v]   = d[v] = Index(g.degree(v));
+      P[v]     = v;
+    }
+    U.reserve( n );
+  }
+
+  ///--------------------------------------------------
+  /// Iterator over the live neighbors of a vertex
+  class AdjIter {
+  public:
+    AdjIter ( const Index* a0, const Index* e0, const unsigned char* alive0 )
+      : a(a0), e(e0), alive(alive0) { next(); }
+    inline bool  operator()() const { return a != e; }
+    inline void  operator++()       { ++a; next(); }
+    inline Index node      () const { return *a; }
+  private:
+    inline void next ( void ) { while ( a != e && !alive[*a] ) ++a; }
+    const Index*         a;
+    const Index*         e;
+    const unsigned char* alive;
+  };
+
+  /// Iterator over the vertices in P
+  class PIter {
+  public:
+    explicit PIter ( const SoALayout& L0 ) : L(L0), i(0), k(L0.P.size()) { next(); }
+    inline bool  operator()() const { return i != k; }
+    inline void  operator++()       { ++i; next(); }
+    inline Index operator* () const { return L.P[i]; }
+    /// Skip the vertices of degree lower than dmin
+    inline void  seek ( Index dmin ) {
+      while ( i != k && ( L.d[L.P[i]] < dmin || !L.inP( L.P[i] ) ) ) {
+	i = L.findDegree( i, dmin );
+	next();
+      }
+    }
+  private:
+    inline void next ( void ) { while ( i != k && !L.inP( L.P[i] ) ) ++i; }
+    const SoALayout& L;
+    size_t           i;
+    size_t           k;
+  };
+
+  inline AdjIter adj ( Index v ) {
+    if ( len[v] > d[v] + d[v]/4 + 8 )
+      compact( v );
+    const Index* a = &nb[0] + start[v];
+    return AdjIter( a, a + len[v], &alive[0] );
+  }
+  inline PIter pIter ( void ) const { return PIter( *this ); }
+
+  inline Index degree   ( Index v ) const { return d[v];   }
+  inline Index degreeU  ( Index v ) const { return u[v];   }
+  inline bool  inP      ( Index v ) const { return pe[v] == epoch; }
+  inline void  incU     ( Index v )       { u[v] += ( pe[v] == epoch ); }
+  inline Color color    ( Index v ) const { return c[v];   }
+  inline void  setColor ( Index v, Color c0 ) { c[v] = c0; }
+  inline bool  empty    ( void )    const { return pLive == 0; }
+
+  /// Vertices in U, in the order they arrived
+  inline const GraphVector<Index>& uList ( void ) const { return U; }
+
+  /// Vertex of P with maximum degree, ties broken at random.
+  /// Only the vertices of degree at least the current maximum can change the
+  /// selection (or draw a random number): the sweep jumps from one to the next.
+  Index maxDegree ( Random& rng ) {
+    compactP();
+    const Index* dd = &d[0];
+    Index v = P[0];
+    for ( size_t i = findDegree( 1, dd[v] ); i < P.size(); i = findDegree( i+1, dd[v] ) ) {
+      Index w = P[i];
+      if ( ( dd[w] > dd[v] ) ||
+	   ( dd[w] == dd[v] && rng()%2 ) )
+	v = w;
+    }
+    return v;
+  }
+
+  /// Vertex of P with maximum degree to U, ties broken by minimum degree
+  Index argmaxU ( void ) {
+    compactP();
+    if ( vec )
+      return P[simd::argmax_hi_lo( &P[0], P.size(), &u[0], &d[0] )];
+    return P[simd::argmax_hi_lo<Index>( &P[0], P.size(), &u[0], &d[0] )];
+  }
+
+  /// Move w from P to the back of U
+  inline void moveToU ( Index w ) {
+    pe[w] = epoch + 1;
+    u[w]  = 0;
+    pLive--;
+    pDead++;
+    U.push_back( w );
+  }
+
+  /// Remove v from P
+  inline void removeFromP ( Index v ) {
+    pe[v] = 0;
+    pLive--;
+    pDead++;
+  }
+
+  /// Remove every edge incident to v: its neighbors lose a degree, and v is
+  /// skipped from now on by every adjacency iterator
+  inline void clearVertex ( Index v ) {
+    for ( AdjIter w = adj( v ); w(); ++w )
+      d[w.node()]--;
+    alive[v] = 0;
+  }
+
+  /// U becomes the new P, in O(1): its vertices carry the next class stamp
+  template <bool counted>
+  void swap ( void ) {
+    P.swap( U );
+    U.clear();
+    pLive = P.size();
+    pDead = 0;
+    epoch++;
+  }
+
+protected:
+  /// First position i >= i0 of the P array with degree at least dmin
+  inline size_t findDegree ( size_t i0, Index dmin ) const {
+    if ( vec )
+      return simd::find_ge( &P[0], i0, P.size(), &d[0], dmin );
+    return simd::find_ge<Index>( &P[0], i0, P.size(), &d[0], dmin );
+  }
+
+  /// Drop the dead entries of the list of v, keeping the order
+  void compact ( Index v ) {
+    Index* a = &nb[0] + start[v];
+    Index  k = 0;
+    for ( Index i = 0; i < len[v]; i++ )
+      if ( alive[a[i]] )
+	a[k++] = a[i];
+    len[v] = k;
+  }
+
+  /// Drop the vertices no longer in P from the P array, keeping the order
+  inline void compactP ( void ) {
+    if ( pDead == 0 )
+      return;
+    size_t k = 0;
+    for ( size_t i = 0; i < P.size(); i++ )
+      if ( pe[P[i]] == epoch )
+	P[k++] = P[i];
+    P.resize( k );
+    pDead = 0;
+  }
+
+  Index                      n;
+  GraphVector<Index>         start;  /// First neighbor of every vertex in nb
+  GraphVector<Index>         len;    /// Length of the list (live and dead entries)
+  GraphVector<Index>         nb;     /// Neighbors
+  GraphVector<Index>         d;      /// Degree in the residual graph
+  GraphVector<Index>         u;      /// Degree induced by U (vertices in P only)
+  GraphVector<uint32_t>      pe;     /// Class whose P holds the vertex (0: colored)
+  uint32_t                   epoch;  /// Class being built
+  GraphVector<unsigned char> alive;  /// If the vertex is not colored yet
+  GraphVector<Color>         c;      /// Color of the vertex
+  GraphVector<Index>         P;      /// Vertices in P, in order (may hold vertices that left P)
+  GraphVector<Index>         U;      /// Vertices in U, in order
+  size_t                     pLive;  /// Vertices in P
+  size_t                     pDead;  /// Entries of the P array no longer in P
+  bool                       vec;    /// If the vectorized kernels can index the vertices
+};
+
+} // namespace rlf
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef _MY_THREAD_POOL_
+#define _MY_THREAD_POOL_
+
+#include <vector>
+using std::vector;
+
+#include <deque>
+using std::deque;
+
+#include <functional>
+using std::function;
+
+#include <thread>
+using std::thread;
+
+#include <mutex>
+using std::mutex;
+
+#include <condition_variable>
+using std::condition_variable;
+
+///------------------------------------------------------------------------------------------
+/// Fixed set of worker threads serving a FIFO queue of tasks
+class ThreadPool {
+public:
+  typedef function<void()> Task;
+
+  /// Start k workers (at least one)
+  explicit ThreadPool ( unsigned int k );
+  /// Wait for the queued tasks, then stop the workers
+  ~ThreadPool ();
+
+  /// Queue a task
+  void push ( const Task& t );
+  /// Wait until the queue is empty and no task is running
+  void wait ( void );
+
+  unsigned int size ( void ) const { return (unsigned int) workers.size(); }
+
+  /// Number of hardware threads (at least 1)
+  static unsigned int hardware ( void );
+
+private:
+  void run ( void );
+
+  vector<thread>     workers;
+  deque<Task>        tasks;
+  unsigned int       running;   /// Tasks being executed
+  bool               stop;
+  mutex              lock;
+  condition_variable ready;     /// A task was queued, or stop
+  condition_variable idle;      /// A task was completed
+
+  ThreadPool ( const ThreadPool& );
+  ThreadPool& operator= ( const ThreadPool& );
+};
+
+///------------------------------------------------------------------------------------------
+/// Fork-join team for short parallel sections inside one computation:
+/// run(f) calls f(0) .. f(k-1) at the same time, f(0) in the calling thread,
+/// and returns when all are done
+class WorkTeam {
+public:
+  typedef function<void(unsigned int)> Job;
+
+  /// Start k-1 helper threads (k at least one)
+  explicit WorkTeam ( unsigned int k );
+  ~WorkTeam ();
+
+  void run ( const Job& f );
+
+  unsigned int size ( void ) const { return k; }
+
+private:
+  void help ( unsigned int t );
+
+  unsigned int       k;
+  vector<thread>     helpers;
+  const Job*         job;
+  unsigned long      round;     /// Incremented by run()
+  unsigned int       pending;   /// Helpers still running the round
+  bool               stop;
+  mutex              lock;
+  condition_variable start;
+  condition_variable done;
+
+  WorkTeam ( const WorkTeam& );
+  WorkTeam& operator= ( const WorkTeam& );
+};
+
+#endif
@@ -5,162 +5,84 @@
  */
 
 #include <iostream>
-#include <fstream>
+#include <cstdlib>
+#include <cstring>
 
-#include <boost/random/linear_congruential.hpp>
-#include <boost/random/uniform_real.hpp>
-#include <boost/random/uniform_int.hpp>
-#include <boost/random/variate_generator.hpp>
+#include <string>
+using std::string;
 
-/// Boost Graph Library
-#include <boost/graph/graph_traits.hpp>
-#include <boost/graph/adjacency_list.hpp>
-using namespace boost;
-typedef adjacency_list < vecS, vecS, undirectedS >   Graph;
-typedef graph_traits<Graph>::edge_descriptor    Edge;
-
-/// Forall define from Boost
-#include <boost/foreach.hpp>
-#define forall         BOOST_FOREACH
-
-#include<boost/tokenizer.hpp>
+#include "graph_io.hpp"
 
 using namespace std;
 
-/*
- * graph_write_dimacs_binary()
- *
- * Writes a binary dimacs-format file of graph g, with comment, to the
- * file stream fp.
- *
- * Returns TRUE if successful, FALSE if an error occurred.
- */
-typedef unsigned long int setelement;
-#define SET_BIT_MASK(x) ((setelement)1<<(x))
-
-#define STR_APPEND(s)			     \
-  if (headerlength+strlen(s) >= headersize) {	\
-    headersize+=1024;				\
-    header=(char*)realloc(header,headersize);	\
-  }						\
-  strncat(header,s,1000);			\
-  headerlength+=strlen(s);
-
-bool graph_write_dimacs_binary ( const Graph& g, FILE *fp ) {
-  char *buf;
-  char *header=NULL;
-  unsigned int headersize=0;
-  unsigned int headerlength=0;
-  int n = num_vertices(g);
-
-//   ASSERT((sizeof(setelement)*8)==ELEMENTSIZE);
-//   ASSERT(graph_test(g,NULL));
-//   ASSERT(fp!=NULL);
-
-  buf=(char*)malloc(std::max(1024,n/8+1));
-  header=(char*)malloc(1024);
-  header[0]=0;
-  headersize=1024;
-
-  sprintf(buf,"p edge %d %d\n",n,int(num_edges(g)));
-  STR_APPEND(buf);
-  
-  fprintf(fp,"%d\n",(int)strlen(header));
-  fprintf(fp,"%s",header);
-  free(header);
-
-  for ( int i = 0; i < n; i++) {
-    memset(buf,0,i/8+1);
-    for ( int j = 0; j<i; j++)
-      if ( edge(i,j,g).second )
-	buf[j/8] |= SET_BIT_MASK(7-j%8);
-
-    fwrite(buf,1,i/8+1,fp);
-  }
-  free(buf);
-  
-  return true;
-}
-
-/*
- * graph_write_dimacs_binary_file()
- *
- * Writes a binary dimacs-format file of graph g, with comment, to
- * given file.
- *
- * Returns TRUE if successful, FALSE if an error occurred.
- */
-bool graph_write_dimacs_binary_file ( const Graph& g, const char *file) {
-  FILE *fp;
-  
-//   ASSERT((sizeof(setelement)*8)==ELEMENTSIZE);
-//   ASSERT(file!=NULL);
-  
-  if ((fp=fopen(file,"wb"))==NULL)
-    return false;
-
-  if (!graph_write_dimacs_binary(g,fp)) {
-    fclose(fp);
-    return false;
-  }
-
-  fclose(fp);
-  return true;
-}
-
-
 /// ------------------------------------------------------------------------------------------
-int main (int argc, char* argv[]) 
+/// Convert a graph among the DIMACS ascii (.col), OR-lib, edge list, DIMACS binary (.b)
+/// and sparse binary (.csr) formats. The input is streamed into an edge list and
+/// turned into a CSR graph: the dense n x n graph is never built.
+int main (int argc, char* argv[])
 {
-  string filename = argv[1];
-
-  /// Read instance from the OR-lib
-  std::ifstream infile(filename.c_str()); 
-  if (!infile) 
-    exit ( EXIT_FAILURE ); 
-
-  int n;     /// Number of variables
-  int m;     /// Number of constraints
-  int k;     /// 
+  if ( argc < 2 ) {
+    cout << "\n\t usage: converter <in> [out] [-from <fmt>] [-to <fmt>] [-raw]\n\n"
+	 << "where <fmt> is one of:\n"
+	 << "\t col   => DIMACS ascii\n"
+	 << "\t orlib => OR-lib adjacency lists (default input)\n"
+	 << "\t edges => edge list, one 0-based \"i j\" pair per line, after a \"# n m\" line\n"
+	 << "\t b     => DIMACS binary (default output)\n"
+	 << "\t csr   => sparse binary, delta/varint compressed\n\n"
+	 << "Formats are guessed from the file extensions when not given.\n"
+	 << "With -raw the sparse binary neighbors are not compressed,\n"
+	 << "so that the engines can map the file and use it in place.\n\n";
+    exit(-1);
+  }
 
-  infile >> n >> m >> k;
-  string buf;
-  std::getline(infile, buf);
+  string      filename = argv[1];
+  string      outname;
+  GraphFormat from = FMT_UNKNOWN;
+  GraphFormat to   = FMT_UNKNOWN;
+  bool        raw  = false;
+
+  for ( int i = 2; i < argc; i++ ) {
+    if ( strcmp( argv[i], "-from" ) == 0 && i+1 < argc )
+      from = format_from_name( argv[++i] );
+    else if ( strcmp( argv[i], "-to" ) == 0 && i+1 < argc )
+      to = format_from_name( argv[++i] );
+    else if ( strcmp( argv[i], "-raw" ) == 0 )
+      raw = true;
+    else
+      outname = argv[i];
+  }
 
-  Graph g;
-  for ( int i = 0; i < n; i++ )
-    add_vertex(g);
-  
-  for ( int i = 0; i < n; i++ ) {
-    string buf;
-    std::getline(infile, buf);
-    
-    tokenizer<> tok(buf);
-    for ( tokenizer<>::iterator beg=tok.begin(); beg!=tok.end(); ++beg)
-      if ( i < atoi((*beg).c_str())-1 )
-	add_edge( i, atoi((*beg).c_str())-1, g );
+  if ( from == FMT_UNKNOWN )
+    from = format_from_extension( filename.c_str() );
+  if ( from == FMT_UNKNOWN )
+    from = is_csr_bin( filename.c_str() ) ? FMT_CSR : FMT_ORLIB;  /// legacy: OR-lib input
+  if ( to == FMT_UNKNOWN && !outname.empty() )
+    to = format_from_extension( outname.c_str() );
+  if ( to == FMT_UNKNOWN )
+    to = FMT_BIN;
+  if ( outname.empty() )
+    outname = filename + format_extension( to );
+
+  CsrGraph g;
+  if ( from == FMT_CSR ) {
+    if ( !read_csr_bin( g, filename.c_str(), true ) )
+      exit ( EXIT_FAILURE );
+  } else {
+    uint32_t    n = 0;
+    CsrEdgeList edges;
+    if ( !read_edges( filename.c_str(), from, n, edges ) ) {
+      cerr << "ERROR: Cannot read " << filename << endl;
+      exit ( EXIT_FAILURE );
+    }
+    csr_from_edges( g, n, edges );
   }
-  
-  filename.append(".b");
-  graph_write_dimacs_binary_file ( g, filename.c_str() );
-  
-  /// Write data in DIMACS format
-//   cout << "c graph converted " << argv[1] << endl;
-//   cout << "p col " << num_vertices(g) << " " << num_edges(g) << endl;
-  
-//   /// Write the matrix d with given density,
-//   /// that is, an edge (i,j) of the bipartite graph is present with probability <d>
-//   forall ( Edge e, edges(g) )
-//     cout << "e " << 1+source(e,g) << " " << 1+target(e,g) << endl;
 
-//   /// Write graph in AMPL format
-//   if ( t == 1 ) {
-//     /// Write the data file in std::out stream
-//     cout << "data;" << endl;
-//     cout << "param n := " << n << ";" << endl;
-    
-//     /// Da completare
-//   }
+  bool ok = ( to == FMT_CSR ) ? write_csr_bin( g, outname.c_str(), !raw )
+                              : write_graph( g, outname.c_str(), to );
+  if ( !ok ) {
+    cerr << "ERROR: Cannot write " << outname << endl;
+    exit ( EXIT_FAILURE );
+  }
 
   return EXIT_SUCCESS;
 }
@@ -0,0 +1,317 @@
+#include <cstdio>
+#include <cstring>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+using std::sort;
+
+#include "csr_graph.hpp"
+
+#define FNV_OFFSET 14695981039346656037ULL
+#define FNV_PRIME  1099511628211ULL
+
+uint64_t csr_checksum ( const void* data, size_t len, uint64_t h ) {
+  const unsigned char* p = (const unsigned char*) data;
+  for ( size_t i = 0; i < len; i++ ) {
+    h ^= p[i];
+    h *= FNV_PRIME;
+  }
+  return h;
+}
+
+CsrGraph::~CsrGraph () {
+  if ( map != NULL )
+    munmap( map, mapLen );
+}
+
+void CsrGraph::attach ( void ) {
+  off = offsets.empty()   ? NULL : &offsets[0];
+  adj = neighbors.empty() ? NULL : &neighbors[0];
+}
+
+void CsrGraph::own ( void ) {
+  if ( map == NULL )
+    return;
+  offsets.assign( off, off+n+1 );
+  neighbors.assign( adj, adj+off[n] );
+  attach();
+  munmap( map, mapLen );
+  map    = NULL;
+  mapLen = 0;
+}
+
+// csr_from_edges() bucket sorts the edges by source vertex (both directions),
+// then sorts every adjacency list and removes duplicates in place
+void csr_from_edges ( CsrGraph& g, uint32_t n, CsrEdgeList& edges ) {
+  g.n = n;
+  g.offsets.assign( n+1, 0 );
+  for ( size_t e = 0; e < edges.size(); e++ )
+    if ( edges[e].first != edges[e].second ) {
+      g.offsets[edges[e].first+1]++;
+      g.offsets[edges[e].second+1]++;
+    }
+  for ( uint32_t v = 0; v < n; v++ )
+    g.offsets[v+1] += g.offsets[v];
+
+  g.neighbors.resize( g.offsets[n] );
+  {
+    vector<uint64_t> pos( g.offsets.begin(), g.offsets.end()-1 );
+    for ( size_t e = 0; e < edges.size(); e++ ) {
+      uint32_t i = edges[e].first;
+      uint32_t j = edges[e].second;
+      if ( i != j ) {
+	g.neighbors[pos[i]++] = j;
+	g.neighbors[pos[j]++] = i;
+      }
+    }
+  }
+  CsrEdgeList().swap( edges );
+
+  /// Sort and compact the lists
+  uint64_t k = 0;
+  uint64_t b = 0;
+  for ( uint32_t v = 0; v < n; v++ ) {
+    uint64_t e = g.offsets[v+1];
+    sort( g.neighbors.begin()+b, g.neighbors.begin()+e );
+    g.offsets[v] = k;
+    for ( uint64_t p = b; p < e; p++ )
+      if ( p == b || g.neighbors[p] != g.neighbors[p-1] )
+	g.neighbors[k++] = g.neighbors[p];
+    b = e;
+  }
+  g.offsets[n] = k;
+  g.neighbors.resize( k );
+  GraphVector<uint32_t>( g.neighbors ).swap( g.neighbors );
+  g.m = k/2;
+  g.attach();
+}
+
+/// Append v as a LEB128 varint
+static inline void put_varint ( vector<unsigned char>& buf, uint32_t v ) {
+  while ( v >= 0x80 ) {
+    buf.push_back( (unsigned char)(v | 0x80) );
+    v >>= 7;
+  }
+  buf.push_back( (unsigned char)v );
+}
+
+bool write_csr_bin ( const CsrGraph& g, const char* name, bool varint ) {
+  FILE* fp = fopen( name, "wb" );
+  if ( fp == NULL )
+    return false;
+
+  CsrHeader h;
+  memset( &h, 0, sizeof(h) );
+  strncpy( h.magic, CSR_MAGIC, sizeof(h.magic) );
+  h.version = CSR_VERSION;
+  h.flags   = varint ? CSR_VARINT : 0;
+  h.n       = g.n;
+  h.m       = g.m;
+
+  vector<uint64_t>      offs( g.n+1, 0 );
+  vector<unsigned char> bytes;
+  const void* section = g.adj;
+  if ( varint ) {
+    for ( uint32_t v = 0; v < g.n; v++ ) {
+      offs[v] = bytes.size();
+      uint32_t last = 0;
+      for ( uint64_t p = g.off[v]; p < g.off[v+1]; p++ ) {
+	put_varint( bytes, g.adj[p] - last );
+	last = g.adj[p];
+      }
+    }
+    offs[g.n]  = bytes.size();
+    h.adjBytes = bytes.size();
+    section    = bytes.empty() ? NULL : &bytes[0];
+  } else {
+    for ( uint32_t v = 0; v <= g.n; v++ )
+      offs[v] = g.off[v];
+    h.adjBytes = g.off[g.n] * sizeof(uint32_t);
+  }
+
+  h.checksum = csr_checksum( &offs[0], offs.size()*sizeof(uint64_t), FNV_OFFSET );
+  h.checksum = csr_checksum( section, h.adjBytes, h.checksum );
+
+  bool ok = fwrite( &h, sizeof(h), 1, fp ) == 1
+    && fwrite( &offs[0], sizeof(uint64_t), offs.size(), fp ) == offs.size()
+    && fwrite( section, 1, h.adjBytes, fp ) == h.adjBytes;
+  return ( fclose( fp ) == 0 ) && ok;
+}
+
+bool is_csr_bin ( const char* name ) {
+  char magic[sizeof(CSR_MAGIC)];
+  FILE* fp = fopen( name, "rb" );
+  if ( fp == NULL )
+    return false;
+  bool ok = fread( magic, 1, sizeof(magic), fp ) == sizeof(magic)
+    && memcmp( magic, CSR_MAGIC, sizeof(magic) ) == 0;
+  fclose( fp );
+  return ok;
+}
+
+// csr_check_offsets() checks that the offsets start at 0, never decrease and
+// end within the neighbor section ('unit' bytes per entry)
+static bool csr_check_offsets ( const uint64_t* offs, uint64_t n, uint64_t adjBytes, size_t unit ) {
+  if ( offs[0] != 0 )
+    return false;
+  for ( uint64_t v = 0; v < n; v++ )
+    if ( offs[v+1] < offs[v] )
+      return false;
+  return offs[n] <= adjBytes / unit;
+}
+
+// csr_check_lists() checks in O(n+m) that every list is strictly increasing,
+// within range, without its own vertex, and that every edge is listed from
+// both ends. Lists are taken in vertex order: the entries v of the list of w
+// must then come in the order the vertices v are met, from next[w] on.
+static bool csr_check_lists ( const uint64_t* off, const uint32_t* adj, uint32_t n ) {
+  vector<uint64_t> next( off, off+n );
+  for ( uint32_t v = 0; v < n; v++ )
+    for ( uint64_t p = off[v]; p < off[v+1]; p++ ) {
+      uint32_t w = adj[p];
+      if ( w >= n || w == v || ( p > off[v] && w <= adj[p-1] ) )
+	return false;
+      if ( next[w] >= off[w+1] || adj[next[w]] != v )
+	return false;
+      next[w]++;
+    }
+  for ( uint32_t w = 0; w < n; w++ )
+    if ( next[w] != off[w+1] )
+      return false;
+  return true;
+}
+
+// read_csr_bin() maps the whole file: the header, offsets and raw neighbors
+// are used where they lie, after an O(n+m) check of their structure
+bool read_csr_bin ( CsrGraph& g, const char* name, bool verify ) {
+  int fd = open( name, O_RDONLY );
+  if ( fd < 0 ) {
+    printf("ERROR: Cannot open infile %s\n", name);
+    return false;
+  }
+  struct stat st;
+  if ( fstat( fd, &st ) != 0 || size_t(st.st_size) < sizeof(CsrHeader) ) {
+    printf("ERROR: Corrupted preamble %s\n", name);
+    close( fd );
+    return false;
+  }
+  size_t len = st.st_size;
+  void*  map = mmap( NULL, len, PROT_READ, MAP_PRIVATE, fd, 0 );
+  close( fd );
+  if ( map == MAP_FAILED ) {
+    printf("ERROR: Cannot map infile %s\n", name);
+    return false;
+  }
+
+  const CsrHeader* h = (const CsrHeader*) map;
+  const char*      p = (const char*) map + sizeof(CsrHeader);
+  /// Sizes compared one at a time with what is left of the file
+  size_t left     = len - sizeof(CsrHeader);
+  size_t offBytes = 0;
+  if ( memcmp( h->magic, CSR_MAGIC, sizeof(CSR_MAGIC) ) != 0 || h->version != CSR_VERSION
+       || h->n > UINT32_MAX ) {
+    printf("ERROR: Corrupted preamble %s\n", name);
+    munmap( map, len );
+    return false;
+  }
+  offBytes = size_t( h->n + 1 ) * sizeof(uint64_t);
+  if ( offBytes > left || h->adjBytes > left - offBytes ) {
+    printf("ERROR: Truncated file %s\n", name);
+    munmap( map, len );
+    return false;
+  }
+  if ( verify ) {
+    uint64_t sum = csr_checksum( p, offBytes, FNV_OFFSET );
+    sum = csr_checksum( p + offBytes, h->adjBytes, sum );
+    if ( sum != h->checksum ) {
+      printf("ERROR: Checksum mismatch %s\n", name);
+      munmap( map, len );
+      return false;
+    }
+  }
+
+  const uint64_t*      offs = (const uint64_t*) p;
+  const unsigned char* adj  = (const unsigned char*) p + offBytes;
+  bool                 varint = ( h->flags & CSR_VARINT ) != 0;
+
+  if ( !csr_check_offsets( offs, h->n, h->adjBytes, varint ? 1 : sizeof(uint32_t) )
+       || h->m > h->adjBytes / 2 || ( !varint && offs[h->n] != 2*h->m ) ) {
+    printf("ERROR: Corrupted offsets %s\n", name);
+    munmap( map, len );
+    return false;
+  }
+  g.n = uint32_t(h->n);
+  g.m = h->m;
+
+  if ( !varint ) {
+    if ( !csr_check_lists( offs, (const uint32_t*) adj, g.n ) ) {
+      printf("ERROR: Corrupted neighbor lists in %s\n", name);
+      munmap( map, len );
+      g.n = 0;
+      g.m = 0;
+      return false;
+    }
+    /// Use the file in place
+    g.off    = offs;
+    g.adj    = (const uint32_t*) adj;
+    g.map    = map;
+    g.mapLen = len;
+    madvise( map, len, MADV_WILLNEED );
+    return true;
+  }
+
+  /// Decode the gaps
+  g.offsets.resize( g.n+1 );
+  g.neighbors.resize( 2*g.m );
+  uint64_t k = 0;
+  for ( uint32_t v = 0; v < g.n; v++ ) {
+    g.offsets[v] = k;
+    const unsigned char* q   = adj + offs[v];
+    const unsigned char* end = adj + offs[v+1];
+    uint32_t last = 0;
+    bool     ok   = true;
+    while ( ok && q < end && k < g.neighbors.size() ) {
+      uint32_t x = 0;
+      int      s = 0;
+      while ( q < end && ( *q & 0x80 ) && s < 28 ) {
+	x |= uint32_t(*q++ & 0x7F) << s;
+	s += 7;
+      }
+      ok = ( q < end ) && !( *q & 0x80 );
+      if ( ok ) {
+	x |= uint32_t(*q++) << s;
+	last += x;
+	ok = ( last < g.n );
+	g.neighbors[k++] = last;
+      }
+    }
+    if ( !ok || q < end ) {
+      printf("ERROR: Corrupted neighbors of vertex %u in %s\n", v, name);
+      munmap( map, len );
+      g.n = 0;
+      g.m = 0;
+      return false;
+    }
+  }
+  g.offsets[g.n] = k;
+  munmap( map, len );
+  g.attach();
+  if ( k != 2*g.m ) {
+    printf("ERROR: %llu neighbors instead of %llu in %s\n", (unsigned long long)k,
+	   (unsigned long long)( 2*g.m ), name);
+    g.n = 0;
+    g.m = 0;
+    return false;
+  }
+  if ( !csr_check_lists( g.off, g.adj, g.n ) ) {
+    printf("ERROR: Corrupted neighbor lists in %s\n", name);
+    g.n = 0;
+    g.m = 0;
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,180 @@
+#include "rlf.hpp"
+#include "rlf_random.hpp"
+
+namespace rlf {
+
+///------------------------------------------------------------------------------------------
+/// Uncolored vertices by saturation: one bucket per saturation, each a max
+/// heap on the degree in the uncolored subgraph, then on a random priority.
+/// A vertex only moves up by one bucket at a time, so the top bucket is found
+/// by a short walk down from the last one.
+class SaturationQueue {
+public:
+  SaturationQueue ( uint32_t n, const vector<uint32_t>& udeg0, const vector<uint32_t>& pri0 )
+    : udeg(udeg0), pri(pri0), sat(n, 0), pos(n, 0), heaps(1), top(0), count(0) {}
+
+  uint32_t saturation ( uint32_t v ) const { return sat[v]; }
+
+  void push ( uint32_t v, uint32_t s ) {
+    if ( s >= heaps.size() )
+      heaps.resize( s+1 );
+    vector<uint32_t>& h = heaps[s];
+    sat[v] = s;
+    pos[v] = uint32_t( h.size() );
+    h.push_back( v );
+    up( h, pos[v] );
+    if ( s > top )
+      top = s;
+    count++;
+  }
+
+  /// Remove and return the vertex of highest saturation
+  uint32_t pop ( void ) {
+    while ( heaps[top].empty() )
+      top--;
+    uint32_t v = heaps[top][0];
+    erase( v );
+    return v;
+  }
+
+  void erase ( uint32_t v ) {
+    vector<uint32_t>& h = heaps[sat[v]];
+    uint32_t i    = pos[v];
+    uint32_t last = h.back();
+    h.pop_back();
+    count--;
+    if ( i < h.size() ) {
+      h[i]      = last;
+      pos[last] = i;
+      up( h, i );
+      down( h, pos[last] );
+    }
+  }
+
+  /// The degree of v in the uncolored subgraph went down
+  void decreased ( uint32_t v ) { down( heaps[sat[v]], pos[v] ); }
+
+  bool empty ( void ) const { return count == 0; }
+
+private:
+  inline bool less ( uint32_t a, uint32_t b ) const {
+    return udeg[a] < udeg[b] || ( udeg[a] == udeg[b] && pri[a] < pri[b] );
+  }
+
+  void up ( vector<uint32_t>& h, uint32_t i ) {
+    uint32_t v = h[i];
+    while ( i > 0 && less( h[(i-1)/2], v ) ) {
+      h[i] = h[(i-1)/2];
+      pos[h[i]] = i;
+      i = (i-1)/2;
+    }
+    h[i]   = v;
+    pos[v] = i;
+  }
+
+  void down ( vector<uint32_t>& h, uint32_t i ) {
+    uint32_t v = h[i];
+    size_t   s = h.size();
+    for ( ;; ) {
+      size_t c = 2*size_t(i) + 1;
+      if ( c >= s )
+	break;
+      if ( c+1 < s && less( h[c], h[c+1] ) )
+	c++;
+      if ( !less( v, h[c] ) )
+	break;
+      h[i] = h[c];
+      pos[h[i]] = i;
+      i = uint32_t(c);
+    }
+    h[i]   = v;
+    pos[v] = i;
+  }
+
+  const vector<uint32_t>&    udeg;
+  const vector<uint32_t>&    pri;
+  vector<uint32_t>           sat;
+  vector<uint32_t>           pos;
+  vector< vector<uint32_t> > heaps;
+  uint32_t                   top;
+  size_t                     count;
+};
+
+///------------------------------------------------------------------------------------------
+/// DSATUR (Brelaz): color next the vertex with most distinct colors among its
+/// neighbors, ties to the highest degree in the uncolored subgraph, and give
+/// it the smallest free color. The colors seen by every vertex are a bitset
+/// row of W words; the rows widen when a color beyond 64 W is opened.
+Color
+color_dsatur ( const CsrGraph& g, const Options& opt, vector<Color>& colors ) {
+  uint32_t n = g.n;
+  Random   rng ( opt.seed );
+
+  vector<uint32_t> udeg( n ), pri( n );
+  for ( uint32_t v = 0; v < n; v++ ) {
+    udeg[v] = g.degree( v );
+    pri[v]  = uint32_t( rng() );
+  }
+  SaturationQueue Q( n, udeg, pri );
+  for ( uint32_t v = 0; v < n; v++ )
+    Q.push( v, 0 );
+
+  size_t           W = 1;
+  vector<uint64_t> seen( size_t(n) * W, 0 );
+  colors.assign( n, 0 );
+  Color k = 0;
+  bool  stopped = false;
+  for ( uint32_t i = 0; i < n; i++ ) {
+    if ( opt.deadline > 0 && ( i & 1023 ) == 0 && clock_ns() >= opt.deadline ) {
+      stopped = true;
+      break;
+    }
+    uint32_t v = Q.pop();
+
+    /// Smallest color (0-based) missing from the row of v
+    const uint64_t* row = &seen[size_t(v) * W];
+    size_t x = 0;
+    while ( x < W && row[x] == ~uint64_t(0) )
+      x++;
+    size_t c = ( x < W ) ? x*64 + __builtin_ctzll( ~row[x] ) : W*64;
+    if ( opt.cutoff > 0 && c+1 > opt.cutoff ) {
+      stopped = true;
+      break;
+    }
+    if ( c >= W*64 ) {
+      /// Widen the rows
+      vector<uint64_t> wide( size_t(n) * 2*W, 0 );
+      for ( uint32_t u = 0; u < n; u++ )
+	for ( size_t y = 0; y < W; y++ )
+	  wide[size_t(u) * 2*W + y] = seen[size_t(u) * W + y];
+      seen.swap( wide );
+      W *= 2;
+    }
+    colors[v] = Color(c+1);
+    if ( colors[v] > k )
+      k = colors[v];
+
+    uint64_t bit = uint64_t(1) << ( c & 63 );
+    for ( uint64_t p = g.off[v]; p < g.off[v+1]; p++ ) {
+      uint32_t u = g.adj[p];
+      if ( colors[u] != 0 )
+	continue;
+      uint64_t& w = seen[size_t(u) * W + c/64];
+      if ( w & bit ) {
+	udeg[u]--;
+	Q.decreased( u );
+      } else {
+	w |= bit;
+	uint32_t s = Q.saturation( u );
+	Q.erase( u );
+	udeg[u]--;
+	Q.push( u, s+1 );
+      }
+    }
+  }
+  if ( stopped )
+    k = first_fit( g, colors );
+  return k;
+}
+
+} // namespace rlf
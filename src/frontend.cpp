@@ -0,0 +1,267 @@
+#include <iostream>
+using std::cout;
+using std::endl;
+using std::cerr;
+
+#include <fstream>
+using std::ifstream;
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <sys/time.h>
+#include <sys/resource.h>
+
+#include "rlf.hpp"
+#include "graph_io.hpp"
+
+/// Engine of the executable, set by the Makefile
+#ifndef RLF_ENGINE
+#define RLF_ENGINE rlf::PLUS
+#endif
+
+///------------------------------------------------------------------------------------------
+/// Command line front-end of librlf:  <engine> <file> [seed] [DD] [options]
+///
+///   -order none|degree|rcm|community   relabel the vertices before coloring
+///   -pages default|huge                 back the graph arrays with 2 MB pages
+///   -numa local|interleave              interleave the graph arrays over the nodes
+///   -complement on|off|auto             store the non-edges (auto: density above 1/2)
+///   -compress                           keep the neighbor lists gap encoded (plus, lazy, adaptive)
+///   -hybrid                             bitset rows for the hubs, lists for the others (plus, lazy, adaptive)
+///   -threads <k>                        plus, adaptive: k threads share every color class (plain
+///                                       layout, warns if not used); jp: k threads
+///   -parts <k>                          color k parts in parallel, then the boundary
+///   -compare                            parts: also run the serial engine, report speedup and overhead
+///   -speculate                          plus: build the next color class ahead in a second thread
+///   -external <MB>                      out of core (.csr files): stream the neighbors, MB for a batch
+///   -passes <k>                         external: passes over the file per color class (2 to 64)
+///   -out <file>                         write the color of every vertex, one per line
+///   -time-limit <sec>                   anytime mode: keep improving for <sec> seconds
+///   -tabu <iterations>                  TabuCol post-optimization, <iterations> moves per color
+///   -bound                              clique lower bound and gap (tabu stops at the bound)
+///------------------------------------------------------------------------------------------
+
+int
+main(int argc, char* argv[])
+{
+  /// Input file
+  if (2 > argc) {
+    cout << "Must specify a filename!\n";
+    return -1;
+  }
+
+  rlf::Options opt;
+  GraphPages   pages = PAGES_DEFAULT;
+  GraphNuma    numa  = NUMA_LOCAL;
+  const char*  out   = NULL;
+  size_t       tabu  = 0;
+  bool         bound = false;
+  unsigned int parts = 0;
+  bool         compare = false;
+  bool         speculate = false;
+  bool         external = false;
+  rlf::ExternalOptions xopt;
+  int pos = 0;
+  for ( int i = 2; i < argc; i++ ) {
+    if ( strcmp( argv[i], "-order" ) == 0 && i+1 < argc ) {
+      opt.order = order_from_name( argv[++i] );
+      if ( opt.order == NUM_ORDERS ) {
+	cerr << "Unknown order " << argv[i] << endl;
+	exit ( EXIT_FAILURE );
+      }
+    } else if ( strcmp( argv[i], "-pages" ) == 0 && i+1 < argc ) {
+      pages = pages_from_name( argv[++i] );
+      if ( pages == NUM_PAGES ) {
+	cerr << "Unknown page policy " << argv[i] << endl;
+	exit ( EXIT_FAILURE );
+      }
+    } else if ( strcmp( argv[i], "-numa" ) == 0 && i+1 < argc ) {
+      numa = numa_from_name( argv[++i] );
+      if ( numa == NUM_NUMA ) {
+	cerr << "Unknown NUMA policy " << argv[i] << endl;
+	exit ( EXIT_FAILURE );
+      }
+    } else if ( ( strcmp( argv[i], "-time-limit" ) == 0 || strcmp( argv[i], "--time-limit" ) == 0 )
+		&& i+1 < argc ) {
+      opt.timeLimit = atof( argv[++i] );
+    } else if ( strcmp( argv[i], "-tabu" ) == 0 && i+1 < argc ) {
+      tabu = strtoul( argv[++i], NULL, 10 );
+    } else if ( strcmp( argv[i], "-complement" ) == 0 && i+1 < argc ) {
+      ++i;
+      if ( strcmp( argv[i], "on" ) == 0 )
+	opt.complement = 1;
+      else if ( strcmp( argv[i], "off" ) == 0 )
+	opt.complement = -1;
+      else if ( strcmp( argv[i], "auto" ) == 0 )
+	opt.complement = 0;
+      else {
+	cerr << "Unknown complement mode " << argv[i] << endl;
+	exit ( EXIT_FAILURE );
+      }
+    } else if ( strcmp( argv[i], "-compress" ) == 0 ) {
+      opt.compress = true;
+    } else if ( strcmp( argv[i], "-hybrid" ) == 0 ) {
+      opt.hybrid = true;
+    } else if ( strcmp( argv[i], "-threads" ) == 0 && i+1 < argc ) {
+      opt.threads = atoi( argv[++i] );
+    } else if ( strcmp( argv[i], "-parts" ) == 0 && i+1 < argc ) {
+      parts = atoi( argv[++i] );
+    } else if ( strcmp( argv[i], "-compare" ) == 0 ) {
+      compare = true;
+    } else if ( strcmp( argv[i], "-speculate" ) == 0 ) {
+      speculate = true;
+    } else if ( strcmp( argv[i], "-external" ) == 0 && i+1 < argc ) {
+      external    = true;
+      xopt.memory = strtoul( argv[++i], NULL, 10 );
+    } else if ( strcmp( argv[i], "-passes" ) == 0 && i+1 < argc ) {
+      char* end;
+      unsigned long r = strtoul( argv[++i], &end, 10 );
+      if ( *end != 0 || r < 2 || r > 64 ) {
+	cerr << "Passes must be between 2 and 64: " << argv[i] << endl;
+	exit ( EXIT_FAILURE );
+      }
+      xopt.passes = (unsigned int) r;
+    } else if ( strcmp( argv[i], "-bound" ) == 0 ) {
+      bound = true;
+    } else if ( strcmp( argv[i], "-out" ) == 0 && i+1 < argc ) {
+      out = argv[++i];
+    } else if ( pos++ == 0 )
+      opt.seed = atoi(argv[i]);
+    else
+      opt.dd = atof(argv[i]);
+  }
+
+  graph_memory_policy( pages, numa );
+
+  if ( external ) {
+    /// The graph is not loaded
+    vector<rlf::Color> colors;
+    rlf::ExternalStats xs;
+    int xhi = rlf::color_external( argv[1], xopt, colors, &xs );
+    if ( xhi == 0 )
+      exit ( EXIT_FAILURE );
+    printf("X(G): %d\tTime: %5.3f sec\n", xhi, xs.seconds);
+    printf("External: %zu passes  Read: %.1f MB\n", xs.passes, xs.bytes/1048576.0);
+    if ( out != NULL && !write_colors( colors, out ) ) {
+      cerr << "Cannot write " << out << endl;
+      exit ( EXIT_FAILURE );
+    }
+    return 1;
+  }
+
+  ifstream infile(argv[1]);
+  if (! infile)
+    {
+      cerr << "No " << argv[1] << " file" << endl;
+      exit ( EXIT_FAILURE );
+    }
+
+  /// Beautify output
+  cout.setf(std::ios_base::fixed, std::ios_base::floatfield);
+  cout.precision(3);
+
+  CsrGraph g;
+  if ( !read_graph ( g, argv[1] ) )
+    exit ( EXIT_FAILURE );
+  infile.close();
+
+  if ( speculate && ( RLF_ENGINE != rlf::PLUS || parts > 0 ) ) {
+    cerr << "Warning: -speculate not used: rlfPlus only, without -parts" << endl;
+    speculate = false;
+  }
+  if ( parts == 0 && !speculate ) {
+    const char* why = rlf::threads_unused( g, RLF_ENGINE, opt );
+    if ( why != NULL )
+      cerr << "Warning: -threads " << opt.threads << " not used: " << why << endl;
+  }
+
+  struct rusage tempo;
+  long int prg_sec0,prg_microsec0,sys_sec0,sys_microsec0;
+  long int prg_sec,prg_microsec,sys_sec,sys_microsec;
+
+  getrusage(RUSAGE_SELF,&tempo);
+  prg_sec0=tempo.ru_utime.tv_sec;  prg_microsec0=tempo.ru_utime.tv_usec;
+  sys_sec0=tempo.ru_stime.tv_sec;  sys_microsec0=tempo.ru_stime.tv_usec;
+
+  vector<rlf::Color> colors;
+  rlf::PartitionStats ps;
+  rlf::SpeculateStats ss;
+  uint64_t wall0 = rlf::clock_ns();
+  int xhi = ( parts > 0 ) ? rlf::color_partitioned( g, RLF_ENGINE, opt, parts, colors, &ps )
+          : speculate     ? rlf::color_speculative( g, opt, colors, &ss )
+                          : rlf::color( g, RLF_ENGINE, opt, colors );
+  double wall = ( rlf::clock_ns() - wall0 ) / 1E9;
+  if ( xhi == 0 && g.n > 0 ) {
+    printf ("The input graph is too large for the %s engine :P\n", rlf::engine_name(RLF_ENGINE));
+    exit(1);
+  }
+  cout << "X(G): " << xhi;
+
+  getrusage(RUSAGE_SELF,&tempo);
+  prg_sec= tempo.ru_utime.tv_sec-prg_sec0;
+  sys_sec= tempo.ru_stime.tv_sec-sys_sec0;
+  prg_microsec=tempo.ru_utime.tv_usec-prg_microsec0;
+  sys_microsec=tempo.ru_stime.tv_usec-sys_microsec0;
+  printf("\tCPU: %5.3f sec   Sys: %5.3f sec\n",
+	 prg_sec+(prg_microsec/1E6),sys_sec+(sys_microsec/1E6));
+
+  if ( parts > 0 ) {
+    printf("Parts: %u  Cut: %llu edges  Boundary: %zu vertices  Interior colors: %u"
+	   "  Time: partition %5.3f  interiors %5.3f  boundary %5.3f sec\n",
+	   ps.parts, (unsigned long long) ps.cut, ps.boundary, ps.interior,
+	   ps.partSeconds, ps.interiorSeconds, ps.boundarySeconds);
+  }
+  if ( speculate )
+    printf("Speculation: %zu of %u classes built ahead, %zu kept\n", ss.tried, ss.classes, ss.adopted);
+  if ( parts > 0 && compare ) {
+    /// Serial run for comparison, on request: it costs a full coloring
+    rlf::Options       so = opt;
+    vector<rlf::Color> sc;
+    so.threads = 1;
+    uint64_t s0 = rlf::clock_ns();
+    int xs = rlf::color( g, RLF_ENGINE, so, sc );
+    double serial = ( rlf::clock_ns() - s0 ) / 1E9;
+    printf("Serial: %d colors  %5.3f sec  Speedup: %.2fx  Overhead: %+d colors\n",
+	   xs, serial, serial / ( wall > 0 ? wall : 1E-9 ), xhi - xs);
+  }
+
+  rlf::Color lb = 0;
+  if ( bound ) {
+    uint64_t t0 = rlf::clock_ns();
+    lb = rlf::clique_bound( g, NULL );
+    printf("Lower bound: %u\tGap: %d\tTime: %5.3f sec\n", lb, xhi - int(lb), ( rlf::clock_ns() - t0 ) / 1E9);
+  }
+
+  if ( tabu > 0 && xhi > int(lb) ) {
+    rlf::TabuOptions to;
+    to.bound      = lb;
+    to.iterations = tabu;
+    to.seed       = opt.seed;
+    vector<rlf::TabuPhase> phases;
+    int k = rlf::tabucol( g, colors, to, &phases );
+    for ( size_t i = 0; i < phases.size(); i++ )
+      printf("Tabu: %u colors  %s  Conflicts: %zu  Moves: %zu  Time: %5.3f sec\n",
+	     phases[i].k, phases[i].solved ? "solved" : "failed", phases[i].conflicts,
+	     phases[i].iterations, phases[i].seconds);
+    printf("X(G) after tabu: %d  (%d fewer)", k, xhi - k);
+    if ( bound )
+      printf("\tGap: %d", k - int(lb));
+    printf("\n");
+  }
+
+  if ( out != NULL && !write_colors( colors, out ) ) {
+    cerr << "Cannot write " << out << endl;
+    exit ( EXIT_FAILURE );
+  }
+
+  if ( pages != PAGES_DEFAULT || numa != NUMA_LOCAL ) {
+    GraphMemStats ms;
+    graph_memory_stats( ms );
+    printf("Pages: %.1f of %.1f MB in 2 MB pages (THP %s), %zu of %zu arrays interleaved on %u nodes\n",
+	   ms.hugeBytes/1048576.0, ms.bytes/1048576.0, ms.thp, ms.interleaved, ms.regions, ms.nodes);
+  }
+
+  return 1;
+}
@@ -0,0 +1,218 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <linux/mempolicy.h>
+
+#include <atomic>
+using std::atomic;
+
+#include <map>
+using std::map;
+
+#include <string>
+using std::string;
+
+#include <mutex>
+using std::mutex;
+using std::lock_guard;
+
+#include "graph_alloc.hpp"
+
+#define HUGE_PAGE  (size_t(2) << 20)
+
+static atomic<int> pages_policy( PAGES_DEFAULT );
+static atomic<int> numa_policy( NUMA_LOCAL );
+
+/// Live mappings and the totals of the released ones (but their huge pages)
+struct Region {
+  size_t len;       /// Mapped length
+  void*  base;      /// Start of the mapping (before the alignment)
+  size_t baseLen;
+  bool   interleaved;
+};
+static mutex               regions_lock;
+static map<void*, Region>  regions;
+static atomic<bool>        mapped( false );   /// If any mapping was made
+static GraphMemStats       released = { 0, 0, 0, 0, 0, "" };
+
+static const char* PAGES_NAMES[NUM_PAGES] = { "default", "huge" };
+static const char* NUMA_NAMES[NUM_NUMA]   = { "local", "interleave" };
+
+GraphPages pages_from_name ( const char* s ) {
+  for ( int p = 0; p < NUM_PAGES; p++ )
+    if ( strcmp( s, PAGES_NAMES[p] ) == 0 )
+      return GraphPages(p);
+  return NUM_PAGES;
+}
+
+GraphNuma numa_from_name ( const char* s ) {
+  for ( int p = 0; p < NUM_NUMA; p++ )
+    if ( strcmp( s, NUMA_NAMES[p] ) == 0 )
+      return GraphNuma(p);
+  return NUM_NUMA;
+}
+
+void graph_memory_policy ( GraphPages pages, GraphNuma numa ) {
+  pages_policy = pages;
+  numa_policy  = numa;
+}
+
+///------------------------------------------------------------------------------------------
+/// Online NUMA nodes, as a bit mask (first 64 nodes)
+static uint64_t online_nodes ( void ) {
+  uint64_t mask = 1;
+  FILE* f = fopen( "/sys/devices/system/node/online", "r" );
+  if ( f == NULL )
+    return mask;
+  char line[256];
+  if ( fgets( line, sizeof(line), f ) != NULL ) {
+    mask = 0;
+    char* p = line;
+    while ( *p != '\0' && *p != '\n' ) {
+      unsigned a = strtoul( p, &p, 10 ), b = a;
+      if ( *p == '-' )
+	b = strtoul( p+1, &p, 10 );
+      for ( unsigned k = a; k <= b && k < 64; k++ )
+	mask |= uint64_t(1) << k;
+      if ( *p == ',' )
+	p++;
+      else if ( *p != '\0' && *p != '\n' )
+	break;
+    }
+  }
+  fclose( f );
+  return mask ? mask : 1;
+}
+
+/// Kernel THP mode: the bracketed word of the sysfs setting
+static string thp_mode ( void ) {
+  string mode = "unknown";
+  FILE* f = fopen( "/sys/kernel/mm/transparent_hugepage/enabled", "r" );
+  if ( f == NULL )
+    return mode;
+  char line[128];
+  if ( fgets( line, sizeof(line), f ) != NULL ) {
+    char* a = strchr( line, '[' );
+    char* b = a ? strchr( a, ']' ) : NULL;
+    if ( b != NULL )
+      mode.assign( a+1, b );
+  }
+  fclose( f );
+  return mode;
+}
+
+/// Bytes of the regions backed by huge pages, from one pass over /proc/self/smaps
+/// (a mapping merged with its neighbors is counted in proportion)
+static size_t huge_bytes ( const map<void*, Region>& live ) {
+  if ( live.empty() )
+    return 0;
+  FILE* f = fopen( "/proc/self/smaps", "r" );
+  if ( f == NULL )
+    return 0;
+  uintptr_t lo = 0, hi = 0;
+  double    total = 0;
+  char      line[512];
+  while ( fgets( line, sizeof(line), f ) != NULL ) {
+    unsigned long s, e;
+    unsigned long kb;
+    /// Mapping lines start with the range, field lines with "Name:"
+    const char* sp = strchr( line, ' ' );
+    if ( sp != NULL && sp[-1] != ':' && sscanf( line, "%lx-%lx ", &s, &e ) == 2 ) {
+      lo = s;
+      hi = e;
+    } else if ( sscanf( line, "AnonHugePages: %lu kB", &kb ) == 1 && kb > 0 ) {
+      /// Regions overlapping [lo, hi), by start address
+      map<void*, Region>::const_iterator it = live.upper_bound( (void*) lo );
+      if ( it != live.begin() )
+	--it;
+      for ( ; it != live.end() && uintptr_t(it->first) < hi; ++it ) {
+	uintptr_t a = uintptr_t(it->first), b = a + it->second.len;
+	uintptr_t x = ( lo > a ) ? lo : a;
+	uintptr_t y = ( hi < b ) ? hi : b;
+	if ( x < y )
+	  total += double(kb) * 1024 * double(y-x) / double(hi-lo);
+      }
+    }
+  }
+  fclose( f );
+  return size_t(total);
+}
+
+///------------------------------------------------------------------------------------------
+void* graph_alloc ( size_t bytes ) {
+  int pages = pages_policy;
+  int numa  = numa_policy;
+  if ( ( pages == PAGES_DEFAULT && numa == NUMA_LOCAL ) || bytes < HUGE_PAGE )
+    return ::operator new( bytes );
+
+  /// Map one more huge page and keep the 2 MB aligned part
+  size_t len     = ( bytes + HUGE_PAGE - 1 ) & ~(HUGE_PAGE - 1);
+  size_t baseLen = len + HUGE_PAGE;
+  void*  base    = mmap( NULL, baseLen, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+  if ( base == MAP_FAILED )
+    throw std::bad_alloc();
+  char* p = (char*)( ( uintptr_t(base) + HUGE_PAGE - 1 ) & ~(uintptr_t(HUGE_PAGE) - 1) );
+
+  if ( pages == PAGES_HUGE )
+    madvise( p, len, MADV_HUGEPAGE );
+  bool interleaved = false;
+  if ( numa == NUMA_INTERLEAVE ) {
+    unsigned long mask = online_nodes();
+    interleaved = syscall( SYS_mbind, p, len, MPOL_INTERLEAVE, &mask, 64, 0 ) == 0;
+  }
+
+  Region r = { len, base, baseLen, interleaved };
+  lock_guard<mutex> guard( regions_lock );
+  regions[p] = r;
+  mapped = true;
+  return p;
+}
+
+void graph_free ( void* p, size_t ) {
+  if ( p == NULL )
+    return;
+  if ( !mapped ) {
+    ::operator delete( p );
+    return;
+  }
+  Region r;
+  {
+    lock_guard<mutex> guard( regions_lock );
+    map<void*, Region>::iterator it = regions.find( p );
+    if ( it == regions.end() ) {
+      ::operator delete( p );
+      return;
+    }
+    r = it->second;
+    regions.erase( it );
+  }
+  {
+    lock_guard<mutex> guard( regions_lock );
+    released.regions++;
+    released.bytes       += r.len;
+    released.interleaved += r.interleaved;
+  }
+  munmap( r.base, r.baseLen );
+}
+
+void graph_memory_stats ( GraphMemStats& s ) {
+  map<void*, Region> live;
+  {
+    lock_guard<mutex> guard( regions_lock );
+    s    = released;
+    live = regions;
+  }
+  for ( map<void*, Region>::iterator it = live.begin(); it != live.end(); ++it ) {
+    s.regions++;
+    s.bytes       += it->second.len;
+    s.interleaved += it->second.interleaved;
+  }
+  s.hugeBytes = huge_bytes( live );
+  s.nodes = __builtin_popcountll( online_nodes() );
+  static const string mode = thp_mode();
+  s.thp   = mode.c_str();
+}
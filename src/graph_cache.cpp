@@ -0,0 +1,86 @@
+#include <sys/stat.h>
+
+#include "graph_cache.hpp"
+#include "graph_io.hpp"
+
+using std::lock_guard;
+
+size_t csr_bytes ( const CsrGraph& g ) {
+  return g.offsets.capacity()*sizeof(uint64_t) + g.neighbors.capacity()*sizeof(uint32_t)
+    + g.mapLen + sizeof(CsrGraph);
+}
+
+GraphCache::GraphCache ( size_t maxGraphs0, size_t maxBytes0 )
+  : maxGraphs(maxGraphs0), maxBytes(maxBytes0), used(0) {}
+
+size_t GraphCache::size ( void ) const {
+  lock_guard<mutex> guard( lock );
+  return lru.size();
+}
+
+size_t GraphCache::bytes ( void ) const {
+  lock_guard<mutex> guard( lock );
+  return used;
+}
+
+shared_ptr<const CsrGraph> GraphCache::get ( const string& name, bool& hit ) {
+  hit = false;
+  struct stat st;
+  if ( stat( name.c_str(), &st ) != 0 )
+    return shared_ptr<const CsrGraph>();
+
+  {
+    lock_guard<mutex> guard( lock );
+    map<string,EntryIter>::iterator it = index.find( name );
+    if ( it != index.end() ) {
+      EntryIter e = it->second;
+      if ( e->mtime == st.st_mtim.tv_sec && e->mtimeNs == st.st_mtim.tv_nsec
+	   && e->fsize == st.st_size ) {
+	/// Move in front of the list
+	lru.splice( lru.begin(), lru, e );
+	hit = true;
+	return e->g;
+      }
+      /// The file has changed: forget the old graph
+      used -= e->bytes;
+      lru.erase( e );
+      index.erase( it );
+    }
+  }
+
+  /// Load without holding the lock, so that the other graphs are still served
+  CsrGraph* g = new CsrGraph();
+  if ( !read_graph( *g, name.c_str() ) ) {
+    delete g;
+    return shared_ptr<const CsrGraph>();
+  }
+  /// A mapped file may be truncated under a long lived graph: keep a copy
+  g->own();
+
+  Entry e;
+  e.name    = name;
+  e.mtime   = st.st_mtim.tv_sec;
+  e.mtimeNs = st.st_mtim.tv_nsec;
+  e.fsize   = st.st_size;
+  e.bytes   = csr_bytes( *g );
+  e.g       = shared_ptr<const CsrGraph>( g );
+
+  lock_guard<mutex> guard( lock );
+  if ( index.find( name ) == index.end() ) {
+    lru.push_front( e );
+    index[name] = lru.begin();
+    used += e.bytes;
+    evict();
+  }
+  return e.g;
+}
+
+void GraphCache::evict ( void ) {
+  while ( lru.size() > 1 && ( ( maxGraphs > 0 && lru.size() > maxGraphs ) ||
+			      ( maxBytes  > 0 && used > maxBytes ) ) ) {
+    Entry& e = lru.back();
+    used -= e.bytes;
+    index.erase( e.name );
+    lru.pop_back();
+  }
+}
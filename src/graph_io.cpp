@@ -0,0 +1,392 @@
+#include <cstdio>
+#include <cstring>
+
+#include <sys/stat.h>
+
+#include "graph_io.hpp"
+
+///------------------------------------------------------------------------------------------
+/// Buffered reader with a fast integer parser
+class FastReader {
+public:
+  explicit FastReader ( FILE* fp0 ) : overflow(false), fp(fp0), bytes(UINT64_MAX), pos(0), len(0) {
+    struct stat st;
+    if ( fstat( fileno( fp ), &st ) == 0 && S_ISREG( st.st_mode ) )
+      bytes = uint64_t(st.st_size);
+  }
+
+  bool overflow;   /// A number did not fit
+
+  /// Size of the file in bytes (UINT64_MAX if not a regular file): bounds
+  /// what a header may claim
+  uint64_t size ( void ) const { return bytes; }
+
+  /// Return the next character without consuming it, EOF at the end
+  inline int peek ( void ) {
+    if ( pos == len && !fill() )
+      return EOF;
+    return buf[pos];
+  }
+  inline int get ( void ) {
+    if ( pos == len && !fill() )
+      return EOF;
+    return buf[pos++];
+  }
+
+  /// Skip blanks (not new lines) and parse an unsigned integer.
+  /// Return false if the next token is not a number, or does not fit in 64
+  /// bits (then 'overflow' is set).
+  inline bool next_uint ( uint64_t& x ) {
+    int c = peek();
+    while ( c == ' ' || c == '\t' || c == '\r' || c == ',' ) {
+      pos++;
+      c = peek();
+    }
+    if ( c < '0' || c > '9' )
+      return false;
+    x = 0;
+    bool big = false;
+    while ( c >= '0' && c <= '9' ) {
+      if ( x > ( UINT64_MAX - uint64_t(c-'0') ) / 10 )
+	big = true;
+      x = x*10 + (c-'0');
+      pos++;
+      c = peek();
+    }
+    overflow |= big;
+    return !big;
+  }
+
+  /// Consume the rest of the current line, new line included
+  inline void skip_line ( void ) {
+    for ( int c = get(); c != '\n' && c != EOF; c = get() );
+  }
+
+  /// Read raw bytes
+  size_t read ( void* out, size_t k ) {
+    size_t r = 0;
+    while ( r < k ) {
+      if ( pos == len && !fill() )
+	break;
+      size_t t = (len-pos < k-r) ? len-pos : k-r;
+      memcpy( (char*)out+r, buf+pos, t );
+      pos += t;
+      r   += t;
+    }
+    return r;
+  }
+
+private:
+  bool fill ( void ) {
+    len = fread( buf, 1, sizeof(buf), fp );
+    pos = 0;
+    return len > 0;
+  }
+
+  FILE*    fp;
+  uint64_t bytes;
+  size_t   pos;
+  size_t   len;
+  char     buf[1<<20];
+};
+
+///------------------------------------------------------------------------------------------
+/// Readers
+
+/// Room for the edges a header announces, no more than a file of 'size' bytes
+/// can hold at 'least' bytes per edge
+static inline uint64_t edges_room ( uint64_t announced, uint64_t size, uint64_t least ) {
+  return ( announced < size / least ) ? announced : size / least;
+}
+
+static bool read_col ( FastReader& in, uint32_t& n, CsrEdgeList& edges ) {
+  uint64_t i, j;
+  n = 0;
+  for ( int c = in.peek(); c != EOF; c = in.peek() ) {
+    if ( c == 'p' ) {
+      /// "p edge n m": skip the problem type
+      in.get();
+      while ( (c = in.peek()) == ' ' ) in.get();
+      while ( (c = in.peek()) != ' ' && c != '\n' && c != EOF ) in.get();
+      if ( !in.next_uint(i) || !in.next_uint(j) || i >= UINT32_MAX )
+	return false;
+      n = uint32_t(i);
+      edges.reserve( edges_room( j, in.size(), 6 ) );   /// "e i j\n"
+    } else if ( c == 'e' ) {
+      in.get();
+      if ( !in.next_uint(i) || !in.next_uint(j) || i == 0 || j == 0 || i > n || j > n )
+	return false;
+      edges.push_back( CsrEdge( uint32_t(i-1), uint32_t(j-1) ) );
+    }
+    in.skip_line();
+  }
+  return n > 0;
+}
+
+static bool read_orlib ( FastReader& in, uint32_t& n, CsrEdgeList& edges ) {
+  uint64_t x, m;
+  if ( !in.next_uint(x) || !in.next_uint(m) || x >= UINT32_MAX )
+    return false;
+  n = uint32_t(x);
+  in.skip_line();
+  edges.reserve( edges_room( m, in.size(), 4 ) );   /// Both ends, "j " at least
+  for ( uint32_t i = 0; i < n && in.peek() != EOF; i++ ) {
+    while ( in.next_uint(x) )
+      /// Every edge is listed twice: keep the copy with i < x
+      if ( x > 0 && i < x-1 && x <= n )
+	edges.push_back( CsrEdge( i, uint32_t(x-1) ) );
+    in.skip_line();
+  }
+  return true;
+}
+
+// read_edge_list() takes the vertex count from a "# n m" header when there is
+// one (isolated vertices at the end are kept), from the largest vertex otherwise
+static bool read_edge_list ( FastReader& in, uint32_t& n, CsrEdgeList& edges ) {
+  uint64_t i, j, declared = 0;
+  bool     header = false;
+  bool     seen   = false;   /// An edge was read: a later "#" line is a comment
+  n = 0;
+  for ( int c = in.peek(); c != EOF; c = in.peek() ) {
+    if ( c == '#' ) {
+      in.get();
+      if ( !header && !seen && in.next_uint(i) && in.next_uint(j) ) {
+	declared = i;
+	header   = true;
+      }
+    } else if ( in.next_uint(i) && in.next_uint(j) ) {
+      if ( i >= UINT32_MAX || j >= UINT32_MAX || ( header && ( i >= declared || j >= declared ) ) )
+	return false;
+      edges.push_back( CsrEdge( uint32_t(i), uint32_t(j) ) );
+      seen = true;
+      if ( i >= n ) n = uint32_t(i+1);
+      if ( j >= n ) n = uint32_t(j+1);
+    }
+    in.skip_line();
+  }
+  if ( header ) {
+    if ( declared > UINT32_MAX )
+      return false;
+    n = uint32_t(declared);
+  }
+  return !in.overflow;
+}
+
+// read_bin() streams the triangular bitmap one row at a time:
+// the whole bitmap is never held in memory
+static bool read_bin ( FastReader& in, uint32_t& n, CsrEdgeList& edges ) {
+  uint64_t pr_len, m = 0;
+  if ( !in.next_uint(pr_len) || pr_len > in.size() )
+    return false;
+  in.skip_line();
+
+  vector<char> header( pr_len+1, 0 );
+  if ( in.read( &header[0], pr_len ) != pr_len )
+    return false;
+  /// The problem line, not a "p " inside a comment
+  const char* p = &header[0];
+  while ( p != NULL && strncmp( p, "p ", 2 ) != 0 ) {
+    p = strchr( p, '\n' );
+    if ( p != NULL ) p++;
+  }
+  unsigned long long nn = 0, mm = 0;
+  if ( p == NULL || sscanf( p, "p %*s %llu %llu", &nn, &mm ) < 1 || nn == 0 || nn >= UINT32_MAX
+       || nn > in.size() )   /// At least one byte per row
+    return false;
+  n = uint32_t(nn);
+  m = mm;
+  edges.reserve( edges_room( m, in.size(), 1 ) );
+
+  vector<unsigned char> row( n/8+1 );
+  for ( uint32_t i = 0; i < n; i++ ) {
+    size_t len = i/8+1;
+    if ( in.read( &row[0], len ) != len )
+      return false;
+    for ( uint32_t j = 0; j < i; j++ )
+      if ( row[j>>3] & (1U << (7-(j&7))) )
+	edges.push_back( CsrEdge( i, j ) );
+  }
+  return true;
+}
+
+bool read_edges ( const char* name, GraphFormat f, uint32_t& n, CsrEdgeList& edges ) {
+  FILE* fp = fopen( name, "rb" );
+  if ( fp == NULL )
+    return false;
+
+  FastReader* in = new FastReader( fp );
+  bool ok = false;
+  edges.clear();
+  switch ( f ) {
+  case FMT_COL:   ok = read_col      ( *in, n, edges ); break;
+  case FMT_ORLIB: ok = read_orlib    ( *in, n, edges ); break;
+  case FMT_EDGES: ok = read_edge_list( *in, n, edges ); break;
+  case FMT_BIN:   ok = read_bin      ( *in, n, edges ); break;
+  default: break;
+  }
+  ok = ok && !in->overflow;
+  delete in;
+  fclose( fp );
+  return ok;
+}
+
+bool read_graph ( CsrGraph& g, const char* name ) {
+  if ( is_csr_bin( name ) )
+    return read_csr_bin( g, name, false );
+
+  uint32_t    n = 0;
+  CsrEdgeList edges;
+  if ( !read_edges( name, FMT_BIN, n, edges ) )
+    return false;
+  csr_from_edges( g, n, edges );
+  return true;
+}
+
+///------------------------------------------------------------------------------------------
+/// Writers
+
+static bool write_bin ( const CsrGraph& g, FILE* fp ) {
+  char header[64];
+  sprintf( header, "p edge %u %llu\n", g.n, (unsigned long long)g.m );
+  fprintf( fp, "%d\n%s", (int)strlen(header), header );
+
+  vector<unsigned char> row( g.n/8+1 );
+  for ( uint32_t i = 0; i < g.n; i++ ) {
+    size_t len = i/8+1;
+    memset( &row[0], 0, len );
+    for ( uint64_t p = g.off[i]; p < g.off[i+1] && g.adj[p] < i; p++ )
+      row[g.adj[p]>>3] |= (unsigned char)(1U << (7-(g.adj[p]&7)));
+    if ( fwrite( &row[0], 1, len, fp ) != len )
+      return false;
+  }
+  return true;
+}
+
+static bool write_ascii ( const CsrGraph& g, FILE* fp, GraphFormat f ) {
+  if ( f == FMT_COL )
+    fprintf( fp, "p edge %u %llu\n", g.n, (unsigned long long)g.m );
+  if ( f == FMT_ORLIB )
+    fprintf( fp, "%u %llu 0\n", g.n, (unsigned long long)g.m );
+  if ( f == FMT_EDGES )
+    fprintf( fp, "# %u %llu\n", g.n, (unsigned long long)g.m );
+
+  for ( uint32_t i = 0; i < g.n; i++ ) {
+    for ( uint64_t p = g.off[i]; p < g.off[i+1]; p++ ) {
+      uint32_t j = g.adj[p];
+      if ( f == FMT_ORLIB )
+	fprintf( fp, p == g.off[i] ? "%u" : " %u", j+1 );
+      else if ( i < j ) {
+	if ( f == FMT_COL )
+	  fprintf( fp, "e %u %u\n", i+1, j+1 );
+	else
+	  fprintf( fp, "%u %u\n", i, j );
+      }
+    }
+    if ( f == FMT_ORLIB )
+      fputc( '\n', fp );
+  }
+  return !ferror( fp );
+}
+
+bool write_graph ( const CsrGraph& g, const char* name, GraphFormat f ) {
+  if ( f == FMT_CSR )
+    return write_csr_bin( g, name, true );
+
+  FILE* fp = fopen( name, "wb" );
+  if ( fp == NULL )
+    return false;
+  bool ok = ( f == FMT_BIN ) ? write_bin( g, fp ) : write_ascii( g, fp, f );
+  return ( fclose( fp ) == 0 ) && ok;
+}
+
+///------------------------------------------------------------------------------------------
+/// Colorings and edge changes
+
+bool read_colors ( const char* name, vector<unsigned int>& colors ) {
+  FILE* fp = fopen( name, "rb" );
+  if ( fp == NULL )
+    return false;
+  FastReader* in = new FastReader( fp );
+  uint64_t x;
+  colors.clear();
+  while ( in->peek() != EOF ) {
+    while ( in->next_uint(x) )
+      colors.push_back( (unsigned int)x );
+    in->get();
+  }
+  bool ok = !in->overflow;
+  delete in;
+  fclose( fp );
+  return ok;
+}
+
+bool write_colors ( const vector<unsigned int>& colors, const char* name ) {
+  FILE* fp = fopen( name, "w" );
+  if ( fp == NULL )
+    return false;
+  for ( size_t v = 0; v < colors.size(); v++ )
+    fprintf( fp, "%u\n", colors[v] );
+  bool ok = !ferror( fp );
+  return ( fclose( fp ) == 0 ) && ok;
+}
+
+bool read_delta ( const char* name, CsrEdgeList& added, CsrEdgeList& removed ) {
+  FILE* fp = fopen( name, "rb" );
+  if ( fp == NULL )
+    return false;
+  FastReader* in = new FastReader( fp );
+  bool ok = true;
+  uint64_t i, j;
+  for ( int c = in->peek(); ok && c != EOF; c = in->peek() ) {
+    while ( c == ' ' || c == '\t' ) {
+      in->get();
+      c = in->peek();
+    }
+    if ( c == '+' || c == '-' ) {
+      in->get();
+      if ( !in->next_uint(i) || !in->next_uint(j) )
+	ok = false;
+      else if ( c == '+' )
+	added.push_back( CsrEdge( uint32_t(i), uint32_t(j) ) );
+      else
+	removed.push_back( CsrEdge( uint32_t(i), uint32_t(j) ) );
+    } else if ( c != '#' && c != '\n' && c != '\r' )
+      ok = false;
+    in->skip_line();
+  }
+  delete in;
+  fclose( fp );
+  return ok;
+}
+
+///------------------------------------------------------------------------------------------
+/// Format names
+
+GraphFormat format_from_name ( const char* s ) {
+  if ( strcmp( s, "col"   ) == 0 ) return FMT_COL;
+  if ( strcmp( s, "orlib" ) == 0 ) return FMT_ORLIB;
+  if ( strcmp( s, "edges" ) == 0 ) return FMT_EDGES;
+  if ( strcmp( s, "b"     ) == 0 ) return FMT_BIN;
+  if ( strcmp( s, "csr"   ) == 0 ) return FMT_CSR;
+  return FMT_UNKNOWN;
+}
+
+GraphFormat format_from_extension ( const char* name ) {
+  const char* dot = strrchr( name, '.' );
+  if ( dot == NULL )
+    return FMT_UNKNOWN;
+  if ( strcmp( dot, ".el" ) == 0 || strcmp( dot, ".txt" ) == 0 )
+    return FMT_EDGES;
+  return format_from_name( dot+1 );
+}
+
+const char* format_extension ( GraphFormat f ) {
+  switch ( f ) {
+  case FMT_COL:   return ".col";
+  case FMT_ORLIB: return ".orlib";
+  case FMT_EDGES: return ".edges";
+  case FMT_BIN:   return ".b";
+  case FMT_CSR:   return ".csr";
+  default:        return "";
+  }
+}
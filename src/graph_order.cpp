@@ -0,0 +1,216 @@
+#include <cstring>
+
+#include <algorithm>
+using std::sort;
+using std::stable_sort;
+using std::reverse;
+
+#include "graph_order.hpp"
+
+static const char* ORDER_NAMES[NUM_ORDERS] = { "none", "degree", "rcm", "community" };
+
+GraphOrder order_from_name ( const char* s ) {
+  for ( int o = 0; o < NUM_ORDERS; o++ )
+    if ( strcmp( s, ORDER_NAMES[o] ) == 0 )
+      return GraphOrder(o);
+  return NUM_ORDERS;
+}
+
+const char* order_name ( GraphOrder o ) {
+  return ( o < NUM_ORDERS ) ? ORDER_NAMES[o] : "unknown";
+}
+
+///------------------------------------------------------------------------------------------
+/// Decreasing degree
+struct ByDegree {
+  explicit ByDegree ( const CsrGraph& g0 ) : g(g0) {}
+  bool operator() ( uint32_t a, uint32_t b ) const { return g.degree( a ) > g.degree( b ); }
+  const CsrGraph& g;
+};
+
+/// Increasing degree
+struct ByMinDegree {
+  explicit ByMinDegree ( const CsrGraph& g0 ) : g(g0) {}
+  bool operator() ( uint32_t a, uint32_t b ) const { return g.degree( a ) < g.degree( b ); }
+  const CsrGraph& g;
+};
+
+static void order_degree ( const CsrGraph& g, vector<uint32_t>& perm ) {
+  perm.resize( g.n );
+  for ( uint32_t v = 0; v < g.n; v++ )
+    perm[v] = v;
+  stable_sort( perm.begin(), perm.end(), ByDegree( g ) );
+}
+
+///------------------------------------------------------------------------------------------
+/// Breadth first visit from s, appending the visited vertices to 'out';
+/// the neighbors of every vertex are queued by increasing degree.
+/// Return the first vertex of minimum degree in the last level.
+static uint32_t bfs ( const CsrGraph& g, uint32_t s, vector<unsigned char>& seen, vector<uint32_t>& out ) {
+  size_t head = out.size();
+  size_t level = head;      /// First vertex of the last level
+  out.push_back( s );
+  seen[s] = 1;
+  while ( head < out.size() ) {
+    size_t end = out.size();
+    level = head;
+    for ( ; head < end; head++ ) {
+      uint32_t v = out[head];
+      size_t first = out.size();
+      for ( uint64_t p = g.off[v]; p < g.off[v+1]; p++ ) {
+	uint32_t w = g.adj[p];
+	if ( !seen[w] ) {
+	  seen[w] = 1;
+	  out.push_back( w );
+	}
+      }
+      stable_sort( out.begin()+first, out.end(), ByMinDegree( g ) );
+    }
+  }
+  uint32_t far = out[level];
+  for ( size_t i = level; i < out.size(); i++ )
+    if ( g.degree( out[i] ) < g.degree( far ) )
+      far = out[i];
+  return far;
+}
+
+/// Cuthill-McKee from a pseudo-peripheral vertex of every component, reversed
+static void order_rcm ( const CsrGraph& g, vector<uint32_t>& perm ) {
+  vector<uint32_t> byDegree( g.n );
+  for ( uint32_t v = 0; v < g.n; v++ )
+    byDegree[v] = v;
+  stable_sort( byDegree.begin(), byDegree.end(), ByMinDegree( g ) );
+
+  vector<unsigned char> seen( g.n, 0 );
+  vector<unsigned char> probe( g.n, 0 );
+  vector<uint32_t>      tmp;
+  perm.clear();
+  perm.reserve( g.n );
+  for ( uint32_t k = 0; k < g.n; k++ ) {
+    uint32_t s = byDegree[k];
+    if ( seen[s] )
+      continue;
+    /// One step of the George-Liu search: restart from the far end
+    tmp.clear();
+    uint32_t far = bfs( g, s, probe, tmp );
+    for ( size_t i = 0; i < tmp.size(); i++ )
+      probe[tmp[i]] = 0;
+    bfs( g, far, seen, perm );
+  }
+  reverse( perm.begin(), perm.end() );
+}
+
+///------------------------------------------------------------------------------------------
+/// Label propagation: every vertex takes the most frequent label among its
+/// neighbors (keeping its own on ties, else the smallest), for a few rounds.
+/// Communities are laid out in order of their first vertex, and every
+/// community in breadth first order restricted to its vertices.
+static void order_community ( const CsrGraph& g, vector<uint32_t>& perm ) {
+  const int ROUNDS = 8;
+  vector<uint32_t> label( g.n );
+  for ( uint32_t v = 0; v < g.n; v++ )
+    label[v] = v;
+
+  vector<uint32_t> count( g.n, 0 );
+  vector<uint32_t> touched;
+  for ( int r = 0; r < ROUNDS; r++ ) {
+    uint32_t changed = 0;
+    for ( uint32_t v = 0; v < g.n; v++ ) {
+      touched.clear();
+      for ( uint64_t p = g.off[v]; p < g.off[v+1]; p++ ) {
+	uint32_t l = label[g.adj[p]];
+	if ( count[l]++ == 0 )
+	  touched.push_back( l );
+      }
+      uint32_t best = label[v];
+      uint32_t top  = count[best];
+      for ( size_t i = 0; i < touched.size(); i++ ) {
+	uint32_t l = touched[i];
+	if ( count[l] > top || ( count[l] == top && best != label[v] && l < best ) ) {
+	  best = l;
+	  top  = count[l];
+	}
+      }
+      for ( size_t i = 0; i < touched.size(); i++ )
+	count[touched[i]] = 0;
+      if ( best != label[v] ) {
+	label[v] = best;
+	changed++;
+      }
+    }
+    if ( changed == 0 )
+      break;
+  }
+
+  /// Number the communities by first vertex, then bucket the vertices
+  vector<uint32_t> id( g.n, UINT32_MAX );
+  uint32_t k = 0;
+  for ( uint32_t v = 0; v < g.n; v++ )
+    if ( id[label[v]] == UINT32_MAX )
+      id[label[v]] = k++;
+  vector<uint32_t> start( k+1, 0 );
+  for ( uint32_t v = 0; v < g.n; v++ )
+    start[id[label[v]]+1]++;
+  for ( uint32_t c = 0; c < k; c++ )
+    start[c+1] += start[c];
+  vector<uint32_t> members( g.n );
+  vector<uint32_t> next( start.begin(), start.end()-1 );
+  for ( uint32_t v = 0; v < g.n; v++ )
+    members[next[id[label[v]]]++] = v;
+
+  vector<unsigned char> seen( g.n, 0 );
+  perm.clear();
+  perm.reserve( g.n );
+  for ( uint32_t i = 0; i < g.n; i++ ) {
+    uint32_t s = members[i];
+    if ( seen[s] )
+      continue;
+    size_t head = perm.size();
+    perm.push_back( s );
+    seen[s] = 1;
+    for ( ; head < perm.size(); head++ ) {
+      uint32_t v = perm[head];
+      for ( uint64_t p = g.off[v]; p < g.off[v+1]; p++ ) {
+	uint32_t w = g.adj[p];
+	if ( !seen[w] && label[w] == label[s] ) {
+	  seen[w] = 1;
+	  perm.push_back( w );
+	}
+      }
+    }
+  }
+}
+
+///------------------------------------------------------------------------------------------
+void vertex_order ( const CsrGraph& g, GraphOrder o, vector<uint32_t>& perm ) {
+  switch ( o ) {
+  case ORDER_DEGREE:    order_degree( g, perm );    break;
+  case ORDER_RCM:       order_rcm( g, perm );       break;
+  case ORDER_COMMUNITY: order_community( g, perm ); break;
+  default:
+    perm.resize( g.n );
+    for ( uint32_t v = 0; v < g.n; v++ )
+      perm[v] = v;
+  }
+}
+
+void permute_graph ( const CsrGraph& g, const vector<uint32_t>& perm, CsrGraph& h ) {
+  vector<uint32_t> inv( g.n );
+  for ( uint32_t i = 0; i < g.n; i++ )
+    inv[perm[i]] = i;
+
+  h.n = g.n;
+  h.m = g.m;
+  h.offsets.resize( g.n+1 );
+  h.neighbors.resize( 2*g.m );
+  h.offsets[0] = 0;
+  for ( uint32_t i = 0; i < g.n; i++ ) {
+    uint32_t v = perm[i];
+    uint64_t p = h.offsets[i];
+    for ( uint64_t q = g.off[v]; q < g.off[v+1]; q++ )
+      h.neighbors[p++] = inv[g.adj[q]];
+    sort( h.neighbors.begin()+h.offsets[i], h.neighbors.begin()+p );
+    h.offsets[i+1] = p;
+  }
+  h.attach();
+}
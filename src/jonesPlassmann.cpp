@@ -0,0 +1,123 @@
+#include <atomic>
+using std::atomic;
+
+#include "rlf.hpp"
+#include "rlf_random.hpp"
+#include "thread_pool.hpp"
+
+namespace rlf {
+
+/// Vertices claimed at a time by a thread of the team
+static const size_t   JP_CHUNK     = 256;
+/// Rounds with fewer ready vertices run in the calling thread
+static const size_t   JP_MIN_ROUND = 4096;
+
+///------------------------------------------------------------------------------------------
+/// Jones-Plassmann greedy coloring, not RLF: a fast parallel first pass.
+///
+/// Every vertex gets a priority, largest degree first with random ties (from
+/// Options::seed). A vertex is ready when all its neighbors of higher priority
+/// are colored, and then takes the smallest color they do not use. Every
+/// round colors the ready vertices; a colored vertex decrements the count of
+/// waiting neighbors of its lower priority ones, and those reaching zero are
+/// ready for the next round. The threads of Options::threads claim chunks of
+/// the round as they become idle. The coloring only depends on the
+/// priorities, so it is the same for any number of threads.
+Color
+color_jp ( const CsrGraph& g, const Options& opt, vector<Color>& colors ) {
+  uint32_t n = g.n;
+  Random   rng ( opt.seed );
+
+  vector<uint64_t> key( n );
+  uint32_t         dmax = 0;
+  for ( uint32_t v = 0; v < n; v++ ) {
+    key[v] = ( uint64_t( g.degree( v ) ) << 32 ) | uint32_t( rng() );
+    if ( g.degree( v ) > dmax )
+      dmax = g.degree( v );
+  }
+  /// If w is colored before v
+  auto before = [&] ( uint32_t w, uint32_t v ) {
+    return key[w] > key[v] || ( key[w] == key[v] && w < v );
+  };
+
+  WorkTeam      team ( opt.threads );
+  unsigned int  T = team.size();
+  colors.assign( n, 0 );
+  vector<uint32_t>           wait( n );
+  vector<uint32_t>           ready;
+  vector< vector<uint32_t> > next( T );
+  vector< vector<uint32_t> > seen( T, vector<uint32_t>( dmax+2, 0 ) );
+  vector<Color>              kmax( T, 0 );
+  atomic<size_t>             at( 0 );
+  atomic<bool>               over( false );
+
+  /// Count the neighbors colored first
+  auto count = [&] ( unsigned int t ) {
+    for ( size_t a; ( a = at.fetch_add( JP_CHUNK ) ) < n; )
+      for ( uint32_t v = uint32_t(a); v < n && v < a + JP_CHUNK; v++ ) {
+	uint32_t c = 0;
+	for ( uint64_t p = g.off[v]; p < g.off[v+1]; p++ )
+	  c += before( g.adj[p], v );
+	wait[v] = c;
+	if ( c == 0 )
+	  next[t].push_back( v );
+      }
+  };
+  /// Color the ready vertices and release their followers
+  auto round = [&] ( unsigned int t ) {
+    uint32_t* s = &seen[t][0];
+    for ( size_t a; ( a = at.fetch_add( JP_CHUNK ) ) < ready.size(); )
+      for ( size_t i = a; i < ready.size() && i < a + JP_CHUNK; i++ ) {
+	uint32_t v = ready[i];
+	for ( uint64_t p = g.off[v]; p < g.off[v+1]; p++ )
+	  if ( before( g.adj[p], v ) )
+	    s[colors[g.adj[p]]] = v+1;
+	Color c = 1;
+	while ( s[c] == v+1 )
+	  c++;
+	if ( opt.cutoff > 0 && c > opt.cutoff ) {
+	  over = true;
+	  continue;
+	}
+	colors[v] = c;
+	if ( c > kmax[t] )
+	  kmax[t] = c;
+	for ( uint64_t p = g.off[v]; p < g.off[v+1]; p++ ) {
+	  uint32_t w = g.adj[p];
+	  if ( before( v, w ) && __atomic_sub_fetch( &wait[w], 1, __ATOMIC_RELAXED ) == 0 )
+	    next[t].push_back( w );
+	}
+      }
+  };
+
+  team.run( count );
+  bool stopped = false;
+  for ( ;; ) {
+    ready.clear();
+    for ( unsigned int t = 0; t < T; t++ ) {
+      ready.insert( ready.end(), next[t].begin(), next[t].end() );
+      next[t].clear();
+    }
+    if ( ready.empty() )
+      break;
+    if ( over || ( opt.deadline > 0 && clock_ns() >= opt.deadline ) ) {
+      stopped = true;
+      break;
+    }
+    at = 0;
+    if ( ready.size() < JP_MIN_ROUND )
+      round( 0 );
+    else
+      team.run( round );
+  }
+
+  Color k = 0;
+  for ( unsigned int t = 0; t < T; t++ )
+    if ( kmax[t] > k )
+      k = kmax[t];
+  if ( stopped || over )
+    k = first_fit( g, colors );
+  return k;
+}
+
+} // namespace rlf
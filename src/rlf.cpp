@@ -1,39 +1,17 @@
-#include <iostream>
-using std::cout;
-using std::endl;
-using std::cerr;
-using std::pair;
-using std::make_pair;
-
-#include <fstream>
-using std::ifstream;
-
-#include <vector>
-using std::vector;
-
-#include <numeric>
-using std::accumulate;
-
-#include "read_dimacs_bin.hpp"
+#include "rlf.hpp"
+#include "rlf_random.hpp"
 
 /// For short integers
 #include <stdint.h>
 
-#include <sys/time.h>
-#include <sys/resource.h>
-
-#ifndef _MY_GRAPH_
-#define _MY_GRAPH_
-typedef vector<bool>           AdjacencyList;
-typedef vector<AdjacencyList>  MyGraph;
-#endif
-
 /// Trace macro
 #ifndef DEBUG
 #define DEBUG false
 #endif
 #define TRACE(X)  if( DEBUG ) X;
 
+namespace rlf {
+
 void my_delete ( vector<int16_t>& H, int16_t M, 
 		 const vector<int32_t>& CI, 
 		 const vector<int16_t>& CL ) {
@@ -45,24 +23,28 @@ void my_delete ( vector<int16_t>& H, int16_t M,
       H[CL[P]] = H[CL[P]] - 1;
 }
 
-int
-RLF( const MyGraph& g ) {
+Color
+color_rlf ( const CsrGraph& g, const Options& opt, vector<Color>& colors ) {
+  /// The PL-1 indices are 16 bits wide
+  if ( g.n >= INT16_MAX || 2*g.m >= INT32_MAX )
+    return 0;
+
+  Random rng ( opt.seed );
 
   /// Initialize the edge array representation of the graph
-  int16_t N  = g.size();
+  int16_t N  = g.n;
   int16_t N1 = N+1;
   vector<int16_t> C (N1,0);
   vector<int32_t> CI(N1,0);
-  vector<int16_t> CL;
+  vector<int16_t> CL(1,0);  /// 1-based: the neighbors of I are CL[CI[I-1]+1..CI[I]]
   
   {
-    int k = 1;
+    int k = 0;
     for ( int i = 0; i < N; i++ ) {
-      for ( int j = 0; j < N; j++ )
-	if ( g[i][j] ) {
-	  CL.push_back( j+1 );
-	  k++;
-	}
+      for ( uint64_t p = g.off[i]; p < g.off[i+1]; p++ ) {
+	CL.push_back( g.adj[p]+1 );
+	k++;
+      }
       CI[i+1] = k;
     }
   }
@@ -86,7 +68,7 @@ RLF( const MyGraph& g ) {
       E[I] = F[I];
     /// Select the node in U1 with maximal degree in U1
     for ( int16_t I = 1; I < N1; I++ )
-      if ( F[I] > F[L] || (F[I] == F[L] && rand()%2 ) )
+      if ( F[I] > F[L] || (F[I] == F[L] && rng()%2 ) )
 	L = I;
     
     /// Color the node just selected and continue to color nodes with
@@ -124,71 +106,10 @@ RLF( const MyGraph& g ) {
     }
   }
 
+  colors.resize( N );
+  for ( int16_t I = 1; I < N1; I++ )
+    colors[I-1] = C[I];
   return COL;
 }
 
-///------------------------------------------------------------------------------------------
-/// UNIT TEST FOR RLF
-///------------------------------------------------------------------------------------------
-
-int
-main(int argc, char* argv[])
-{
-  /// Input file
-  if (2 > argc) {
-    cout << "Must specify a filename!\n";
-    return -1;
-  }
-
-  if ( argc > 2 )
-    srand(atoi(argv[2]));
-  
-  ifstream infile(argv[1]); 
-  if (! infile) 
-    { 
-      cerr << "No " << argv[1] << " file" << endl; 
-      exit ( EXIT_FAILURE ); 
-    }
-
-  MyGraph g;
-  read_dimacs_bin ( g, argv[1] );
-  infile.close();
-
-  if ( g.size() > UINT16_MAX ) {
-    printf ("The input graph has more than %u vertices. That's too much :P\n", UINT16_MAX);
-    exit(1);
-  }
-  unsigned int m = 0;
-  for ( unsigned int i = 0; i < g.size(); i++ ) {
-    m += accumulate( g[i].begin(), g[i].end(), m );
-  }
-  if ( m > UINT32_MAX ) {
-    printf ("The input graph has more than %u edges. That's too much :P\n", INT32_MAX);
-    exit(1);
-  }
-
-  /// Beautify output
-  cout.setf(std::ios_base::fixed, std::ios_base::floatfield);
-  cout.precision(3);
-
-  struct rusage tempo;
-  long int prg_sec0,prg_microsec0,sys_sec0,sys_microsec0;
-  long int prg_sec,prg_microsec,sys_sec,sys_microsec;
-
-  getrusage(RUSAGE_SELF,&tempo);
-  prg_sec0=tempo.ru_utime.tv_sec;  prg_microsec0=tempo.ru_utime.tv_usec;
-  sys_sec0=tempo.ru_stime.tv_sec;  sys_microsec0=tempo.ru_stime.tv_usec;
-
-  int xhi = RLF(g);
-  cout << "X(G): " << xhi;
-
-  getrusage(RUSAGE_SELF,&tempo);
-  prg_sec= tempo.ru_utime.tv_sec-prg_sec0;
-  sys_sec= tempo.ru_stime.tv_sec-sys_sec0;
-  prg_microsec=tempo.ru_utime.tv_usec-prg_microsec0;
-  sys_microsec=tempo.ru_stime.tv_usec-sys_microsec0;
-  printf("\tCPU: %5.3f sec   Sys: %5.3f sec\n",
-	 prg_sec+(prg_microsec/1E6),sys_sec+(sys_microsec/1E6));
-
-  return 1;
-}
+} // namespace rlf
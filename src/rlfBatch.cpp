@@ -0,0 +1,422 @@
+/*
+ *  rlfBatch: run a manifest of coloring jobs in a single process.
+ *
+ *  Manifest: one job per line, "#" starts a comment
+ *
+ *    <file> [seed] [DD] [engine]
+ *
+ *  Jobs are grouped by file: every graph is loaded once and its jobs run on
+ *  a bounded pool of threads. A memory budget (-mem) delays the loading of
+ *  the next graph and the start of new jobs until enough memory is released.
+ *  Results are written on stdout as NDJSON, one line per job, as they finish.
+ *  With -stop-at-bound, every line also reports the clique lower bound of the
+ *  graph and the gap to it, and the jobs of a file still queued when one of
+ *  them meets the bound are skipped.
+ *
+ *  With -pack <r>, every line is packed r times into one batch of graphs,
+ *  colored by rlf::color_batch with the options of the command line (seeds,
+ *  DD and engines of the lines are ignored); a line per job, then a summary
+ *  with the graphs per second.
+ */
+
+#include <iostream>
+using std::cout;
+using std::cerr;
+using std::endl;
+
+#include <fstream>
+using std::ifstream;
+using std::istream;
+
+#include <sstream>
+using std::istringstream;
+using std::ostringstream;
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+#include <sys/stat.h>
+
+#include <algorithm>
+
+#include <atomic>
+using std::atomic;
+
+#include "rlf.hpp"
+#include "graph_io.hpp"
+#include "graph_cache.hpp"
+#include "thread_pool.hpp"
+
+using std::unique_lock;
+using std::lock_guard;
+
+///------------------------------------------------------------------------------------------
+/// Bytes in use, bounded by a limit: acquire() waits until the request fits.
+/// Only running jobs can give memory back (a loaded graph is released by its
+/// last job), so a request is admitted anyway when no job is running: a single
+/// job larger than the limit still runs, alone.
+class MemoryBudget {
+public:
+  explicit MemoryBudget ( size_t limit0 ) : limit(limit0), used(0), jobs(0) {}
+
+  void acquire ( size_t k, bool job ) {
+    unique_lock<mutex> guard( lock );
+    while ( limit > 0 && jobs > 0 && used + k > limit )
+      freed.wait( guard );
+    used += k;
+    jobs += job;
+  }
+
+  void release ( size_t k, bool job ) {
+    {
+      lock_guard<mutex> guard( lock );
+      used -= k;
+      jobs -= job;
+    }
+    freed.notify_all();
+  }
+
+private:
+  size_t             limit;
+  size_t             used;
+  size_t             jobs;    /// Running (or admitted) jobs
+  mutex              lock;
+  condition_variable freed;
+};
+
+/// Memory of the engine arrays built from g (vertex arrays and adjacency copy)
+static size_t engine_bytes ( const CsrGraph& g ) {
+  return size_t(g.n) * 32 + size_t(g.m) * 2 * 4;
+}
+
+/// CPU time of the calling thread, in seconds
+static double thread_time ( void ) {
+  struct timespec t;
+  clock_gettime( CLOCK_THREAD_CPUTIME_ID, &t );
+  return t.tv_sec + t.tv_nsec/1E9;
+}
+
+/// JSON string literal
+static string quote ( const string& s ) {
+  string r = "\"";
+  for ( size_t i = 0; i < s.size(); i++ ) {
+    unsigned char c = s[i];
+    if ( c == '"' || c == '\\' ) {
+      r += '\\';
+      r += c;
+    } else if ( c < 0x20 ) {
+      char buf[8];
+      sprintf( buf, "\\u%04x", c );
+      r += buf;
+    } else
+      r += c;
+  }
+  return r + "\"";
+}
+
+struct Job {
+  size_t       id;       /// Line of the manifest
+  rlf::Engine  engine;
+  rlf::Options opt;
+};
+
+struct Group {
+  string      file;
+  vector<Job> jobs;
+};
+
+/// Output stream shared by the workers
+static mutex out_lock;
+
+static void emit ( const string& line ) {
+  lock_guard<mutex> guard( out_lock );
+  cout << line << endl;
+}
+
+/// Jobs of one file with -stop-at-bound: the clique lower bound, computed by
+/// the first job that needs it, and whether a job reached it
+struct Bound {
+  Bound ( void ) : known(false), lb(0), met(false) {}
+
+  rlf::Color get ( const CsrGraph& g ) {
+    lock_guard<mutex> guard( lock );
+    if ( !known ) {
+      lb    = rlf::clique_bound( g, NULL );
+      known = true;
+    }
+    return lb;
+  }
+
+  mutex        lock;
+  bool         known;
+  rlf::Color   lb;
+  atomic<bool> met;
+};
+
+/// Run a job; 'bound' is NULL unless the jobs stop at the bound
+static void run_job ( const string& file, const Job& job, const CsrGraph& g, Bound* bound ) {
+  if ( bound != NULL && bound->met ) {
+    emit( "{\"job\":" + std::to_string( job.id ) + ",\"file\":" + quote( file )
+	  + ",\"bound\":" + std::to_string( bound->lb ) + ",\"skipped\":\"bound reached\"}" );
+    return;
+  }
+  vector<rlf::Color> colors;
+  double t0 = thread_time();
+  rlf::Color k = rlf::color( g, job.engine, job.opt, colors );
+  double t1 = thread_time();
+  rlf::Color lb = 0;
+  if ( bound != NULL && k > 0 ) {
+    lb = bound->get( g );
+    if ( k == lb )
+      bound->met = true;
+  }
+
+  ostringstream out;
+  out.setf( std::ios_base::fixed, std::ios_base::floatfield );
+  out.precision( 3 );
+  out << "{\"job\":" << job.id << ",\"file\":" << quote( file )
+      << ",\"engine\":\"" << rlf::engine_name( job.engine ) << "\""
+      << ",\"seed\":" << job.opt.seed << ",\"dd\":" << job.opt.dd
+      << ",\"order\":\"" << order_name( job.opt.order ) << "\""
+      << ",\"n\":" << g.n << ",\"m\":" << g.m;
+  if ( k == 0 && g.n > 0 )
+    out << ",\"error\":\"graph too large for the engine\"}";
+  else {
+    out << ",\"colors\":" << k;
+    if ( bound != NULL )
+      out << ",\"bound\":" << lb << ",\"gap\":" << ( k - lb );
+    out << ",\"time\":" << (t1-t0) << "}";
+  }
+  emit( out.str() );
+}
+
+/// Read the manifest, grouping the jobs by file in order of first appearance
+static bool read_manifest ( istream& in, rlf::Engine engine, const rlf::Options& opt, vector<Group>& groups ) {
+  map<string,size_t> index;
+  string line;
+  size_t id = 0;
+  while ( std::getline( in, line ) ) {
+    id++;
+    size_t hash = line.find( '#' );
+    if ( hash != string::npos )
+      line.erase( hash );
+    istringstream tok( line );
+    string file, name;
+    Job job;
+    job.id     = id;
+    job.engine = engine;
+    job.opt    = opt;
+    if ( !(tok >> file) )
+      continue;
+    tok >> job.opt.seed >> job.opt.dd;
+    if ( tok >> name ) {
+      job.engine = rlf::engine_from_name( name.c_str() );
+      if ( job.engine == rlf::NUM_ENGINES ) {
+	cerr << "ERROR: unknown engine " << name << " at line " << id << endl;
+	return false;
+      }
+    }
+    map<string,size_t>::iterator it = index.find( file );
+    if ( it == index.end() ) {
+      it = index.insert( make_pair( file, groups.size() ) ).first;
+      groups.push_back( Group() );
+      groups.back().file = file;
+    }
+    groups[it->second].jobs.push_back( job );
+  }
+  return true;
+}
+
+/// Pack the graphs of the jobs (each r times) into one batch, color it and
+/// report every job and the throughput
+static void run_packed ( const vector<Group>& groups, unsigned int r, rlf::Engine engine, const rlf::Options& opt ) {
+  vector<uint64_t> first( 1, 0 ), off;
+  vector<uint32_t> adj;
+  vector<size_t>   at;       /// First graph of every job (0 if not read)
+  vector<string>   names;
+  vector<size_t>   ids;
+  vector<bool>     read;
+  for ( size_t k = 0; k < groups.size(); k++ ) {
+    const Group& group = groups[k];
+    CsrGraph g;
+    bool ok = read_graph( g, group.file.c_str() );
+    for ( size_t j = 0; j < group.jobs.size(); j++ ) {
+      ids.push_back( group.jobs[j].id );
+      names.push_back( group.file );
+      read.push_back( ok );
+      at.push_back( first.size() - 1 );
+      for ( unsigned int q = 0; ok && q < r; q++ ) {
+	uint64_t base = adj.size();
+	for ( uint32_t v = 0; v < g.n; v++ )
+	  off.push_back( base + g.off[v] - g.off[0] );
+	adj.insert( adj.end(), g.adj + g.off[0], g.adj + g.off[g.n] );
+	first.push_back( first.back() + g.n );
+      }
+    }
+  }
+  off.push_back( adj.size() );
+
+  rlf::GraphBatch b;
+  b.graphs = first.size() - 1;
+  b.first  = &first[0];
+  b.off    = &off[0];
+  b.adj    = adj.empty() ? NULL : &adj[0];
+  vector<rlf::Color> colors( first.back() + 1 ), k( b.graphs + 1 );
+  rlf::BatchStats st;
+  rlf::color_batch( b, engine, opt, &colors[0], &k[0], &st );
+
+  ostringstream out;
+  out.setf( std::ios_base::fixed, std::ios_base::floatfield );
+  out.precision( 3 );
+  for ( size_t j = 0; j < ids.size(); j++ ) {
+    out << "{\"job\":" << ids[j] << ",\"file\":" << quote( names[j] );
+    if ( !read[j] )
+      out << ",\"error\":\"cannot read\"}\n";
+    else
+      out << ",\"n\":" << ( first[at[j]+1] - first[at[j]] ) << ",\"colors\":" << k[at[j]] << "}\n";
+  }
+  out << "{\"graphs\":" << st.graphs << ",\"vertices\":" << st.vertices << ",\"failed\":" << st.failed
+      << ",\"engine\":\"" << rlf::engine_name( engine ) << "\",\"threads\":" << opt.threads
+      << ",\"time\":" << st.seconds;
+  out.precision( 0 );
+  out << ",\"graphs_per_sec\":" << ( st.seconds > 0 ? st.graphs / st.seconds : 0.0 ) << "}";
+  emit( out.str() );
+}
+
+///------------------------------------------------------------------------------------------
+int
+main(int argc, char* argv[])
+{
+  if ( argc < 2 ) {
+    cout << "\n\t usage: rlfBatch <manifest|-> [-threads <k>] [-mem <MB>] [-engine <name>] [-order <name>] [-time-limit <sec>]"
+	 << " [-pages default|huge] [-numa local|interleave] [-pack <r>] [-stop-at-bound]\n\n"
+	 << "Manifest lines: <file> [seed] [DD] [engine]\n\n";
+    exit(-1);
+  }
+
+  unsigned int threads = ThreadPool::hardware();
+  size_t       maxMB   = 0;
+  rlf::Engine  engine  = rlf::PLUS;
+  rlf::Options opt;
+  GraphPages   pages   = PAGES_DEFAULT;
+  GraphNuma    numa    = NUMA_LOCAL;
+  unsigned int pack    = 0;
+  bool         stop    = false;
+  for ( int i = 2; i < argc; i++ ) {
+    if ( strcmp( argv[i], "-stop-at-bound" ) == 0 )
+      stop = true;
+    else if ( i+1 >= argc )
+      break;
+    else if ( strcmp( argv[i], "-threads" ) == 0 )
+      threads = atoi( argv[++i] );
+    else if ( strcmp( argv[i], "-mem" ) == 0 )
+      maxMB = atoi( argv[++i] );
+    else if ( strcmp( argv[i], "-engine" ) == 0 )
+      engine = rlf::engine_from_name( argv[++i] );
+    else if ( strcmp( argv[i], "-order" ) == 0 )
+      opt.order = order_from_name( argv[++i] );
+    else if ( strcmp( argv[i], "-time-limit" ) == 0 )
+      opt.timeLimit = atof( argv[++i] );
+    else if ( strcmp( argv[i], "-pages" ) == 0 )
+      pages = pages_from_name( argv[++i] );
+    else if ( strcmp( argv[i], "-numa" ) == 0 )
+      numa = numa_from_name( argv[++i] );
+    else if ( strcmp( argv[i], "-pack" ) == 0 )
+      pack = atoi( argv[++i] );
+  }
+  if ( engine == rlf::NUM_ENGINES ) {
+    cerr << "ERROR: unknown engine" << endl;
+    exit ( EXIT_FAILURE );
+  }
+  if ( opt.order == NUM_ORDERS ) {
+    cerr << "ERROR: unknown order" << endl;
+    exit ( EXIT_FAILURE );
+  }
+  if ( pages == NUM_PAGES || numa == NUM_NUMA ) {
+    cerr << "ERROR: unknown memory policy" << endl;
+    exit ( EXIT_FAILURE );
+  }
+  graph_memory_policy( pages, numa );
+
+  vector<Group> groups;
+  bool ok;
+  if ( strcmp( argv[1], "-" ) == 0 )
+    ok = read_manifest( std::cin, engine, opt, groups );
+  else {
+    ifstream infile( argv[1] );
+    if ( !infile ) {
+      cerr << "No " << argv[1] << " file" << endl;
+      exit ( EXIT_FAILURE );
+    }
+    ok = read_manifest( infile, engine, opt, groups );
+  }
+  if ( !ok )
+    exit ( EXIT_FAILURE );
+
+  if ( pack > 0 ) {
+    opt.threads = threads;
+    run_packed( groups, pack, engine, opt );
+    return EXIT_SUCCESS;
+  }
+
+  MemoryBudget budget( maxMB << 20 );
+  ThreadPool   pool( threads );
+  bool         policy   = ( pages != PAGES_DEFAULT || numa != NUMA_LOCAL );
+  size_t       hugePeak = 0;   /// Most bytes in huge pages seen after a load
+
+  for ( size_t k = 0; k < groups.size(); k++ ) {
+    const Group& group = groups[k];
+
+    /// Reserve the file size while loading, then the actual graph size
+    struct stat st;
+    size_t estimate = ( stat( group.file.c_str(), &st ) == 0 ) ? st.st_size : 0;
+    budget.acquire( estimate, false );
+    shared_ptr<CsrGraph> g( new CsrGraph() );
+    if ( !read_graph( *g, group.file.c_str() ) ) {
+      budget.release( estimate, false );
+      for ( size_t j = 0; j < group.jobs.size(); j++ )
+	emit( "{\"job\":" + std::to_string( group.jobs[j].id ) + ",\"file\":" + quote( group.file )
+	      + ",\"error\":\"cannot read\"}" );
+      continue;
+    }
+    size_t graphBytes = csr_bytes( *g );
+    budget.release( estimate, false );
+    budget.acquire( graphBytes, false );
+    /// Huge pages are only seen in the live mappings: sample them now
+    if ( policy ) {
+      GraphMemStats ms;
+      graph_memory_stats( ms );
+      hugePeak = std::max( hugePeak, ms.hugeBytes );
+    }
+
+    /// With -stop-at-bound, the jobs still queued are skipped once one meets the bound
+    shared_ptr<Bound> bound( stop ? new Bound() : NULL );
+
+    /// The last job of the group releases the graph
+    shared_ptr< atomic<size_t> > left( new atomic<size_t>( group.jobs.size() ) );
+    size_t jobBytes = engine_bytes( *g );
+    for ( size_t j = 0; j < group.jobs.size(); j++ ) {
+      budget.acquire( jobBytes, true );
+      const Job* job = &group.jobs[j];
+      pool.push( [&budget, &group, job, g, bound, left, jobBytes, graphBytes] () {
+	  run_job( group.file, *job, *g, bound.get() );
+	  budget.release( jobBytes, true );
+	  if ( --(*left) == 0 )
+	    budget.release( graphBytes, false );
+	} );
+    }
+  }
+  pool.wait();
+
+  if ( policy ) {
+    GraphMemStats ms;
+    graph_memory_stats( ms );
+    cerr << "Pages: up to " << hugePeak << " bytes in 2 MB pages, " << ms.bytes << " bytes mapped (THP " << ms.thp
+	 << "), " << ms.interleaved << " of " << ms.regions << " arrays interleaved on "
+	 << ms.nodes << " nodes" << endl;
+  }
+
+  return EXIT_SUCCESS;
+}
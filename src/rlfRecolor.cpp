@@ -0,0 +1,93 @@
+/*
+ *  rlfRecolor: update a coloring after a change of the graph.
+ *
+ *    rlfRecolor <graph> <colors> <delta> [-tolerance k] [-engine name] [-seed s] [-out file]
+ *
+ *  <colors> is a valid coloring of <graph> (one color per vertex, as written
+ *  by the front-ends with -out); <delta> lists the changed edges, one per
+ *  line, "+ i j" for an added edge and "- i j" for a removed one (0-based).
+ *  The coloring of the changed graph is written to -out.
+ */
+
+#include <iostream>
+using std::cout;
+using std::cerr;
+using std::endl;
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+#include "rlf.hpp"
+#include "graph_io.hpp"
+
+/// CPU time of the process, in seconds
+static double cpu_time ( void ) {
+  struct timespec t;
+  clock_gettime( CLOCK_PROCESS_CPUTIME_ID, &t );
+  return t.tv_sec + t.tv_nsec/1E9;
+}
+
+///------------------------------------------------------------------------------------------
+int
+main(int argc, char* argv[])
+{
+  if ( argc < 4 ) {
+    cout << "\n\t usage: rlfRecolor <graph> <colors> <delta> [-tolerance <k>] [-engine <name>]"
+	 << " [-seed <s>] [-out <file>]\n\n"
+	 << "Delta lines: + i j (added edge), - i j (removed edge), 0-based\n\n";
+    exit(-1);
+  }
+
+  rlf::RecolorOptions ro;
+  const char* out = NULL;
+  for ( int i = 4; i+1 < argc; i += 2 ) {
+    if ( strcmp( argv[i], "-tolerance" ) == 0 )
+      ro.tolerance = atoi( argv[i+1] );
+    else if ( strcmp( argv[i], "-engine" ) == 0 )
+      ro.engine = rlf::engine_from_name( argv[i+1] );
+    else if ( strcmp( argv[i], "-seed" ) == 0 )
+      ro.opt.seed = atoi( argv[i+1] );
+    else if ( strcmp( argv[i], "-out" ) == 0 )
+      out = argv[i+1];
+  }
+  if ( ro.engine == rlf::NUM_ENGINES ) {
+    cerr << "ERROR: unknown engine" << endl;
+    exit ( EXIT_FAILURE );
+  }
+
+  CsrGraph g;
+  if ( !read_graph( g, argv[1] ) ) {
+    cerr << "No " << argv[1] << " file" << endl;
+    exit ( EXIT_FAILURE );
+  }
+  vector<rlf::Color> colors;
+  if ( !read_colors( argv[2], colors ) || colors.size() != g.n ) {
+    cerr << "ERROR: " << argv[2] << " does not hold one color per vertex" << endl;
+    exit ( EXIT_FAILURE );
+  }
+  rlf::EdgeDelta delta;
+  if ( !read_delta( argv[3], delta.added, delta.removed ) ) {
+    cerr << "ERROR: cannot read the delta " << argv[3] << endl;
+    exit ( EXIT_FAILURE );
+  }
+
+  rlf::RecolorStats st;
+  double t0 = cpu_time();
+  rlf::Color k = rlf::recolor( g, delta, ro, colors, &st );
+  double t1 = cpu_time();
+  if ( k == 0 && g.n > 0 ) {
+    cerr << "ERROR: the delta does not fit the graph" << endl;
+    exit ( EXIT_FAILURE );
+  }
+
+  printf( "X(G): %u\tConflicts: %zu  Greedy: %zu  Kempe: %zu  Local: %zu  Full: %d\tCPU: %5.3f sec\n",
+	  k, st.conflicts, st.greedy, st.kempe, st.local, int(st.full), t1-t0 );
+
+  if ( out != NULL && !write_colors( colors, out ) ) {
+    cerr << "Cannot write " << out << endl;
+    exit ( EXIT_FAILURE );
+  }
+  return EXIT_SUCCESS;
+}
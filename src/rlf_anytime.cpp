@@ -0,0 +1,119 @@
+#include <algorithm>
+using std::sort;
+using std::make_pair;
+
+#include "rlf_anytime.hpp"
+
+namespace rlf {
+
+Anytime::Anytime ( const CsrGraph& g0, Engine e, const Options& opt0 )
+  : g(g0), engine(e), opt(opt0), bestK(0), lb(0), nRuns(0), nElim(0), stamp(0) {
+  opt.timeLimit = 0.0;
+  opt.cutoff    = 0;
+  deadline      = clock_ns() + uint64_t( opt0.timeLimit * 1E9 );
+  opt.deadline  = deadline;
+}
+
+void Anytime::publish ( const vector<Color>& colors, Color k ) {
+  ColorsPtr p( new vector<Color>( colors ) );
+  std::atomic_store( &bestColors, p );
+  bestK = k;
+}
+
+Color Anytime::best ( vector<Color>& colors ) const {
+  ColorsPtr p = std::atomic_load( &bestColors );
+  if ( !p ) {
+    colors.clear();
+    return 0;
+  }
+  colors = *p;
+  Color k = 0;
+  for ( size_t v = 0; v < colors.size(); v++ )
+    if ( colors[v] > k )
+      k = colors[v];
+  return k;
+}
+
+// eliminate() tries the classes from the smallest one: every vertex of the
+// class moves to the first other class with none of its neighbors, in order;
+// if one of them fits nowhere the moves are undone. The classes above the
+// emptied one are renumbered down by one. The colors next to a vertex are
+// stamped in 'used', kept from call to call: nothing is cleared.
+bool Anytime::eliminate ( vector<Color>& colors, Color k ) {
+  vector< vector<uint32_t> > classes( k+1 );
+  for ( uint32_t v = 0; v < g.n; v++ )
+    classes[colors[v]].push_back( v );
+  vector< pair<size_t, Color> > order;
+  for ( Color c = 1; c <= k; c++ )
+    order.push_back( make_pair( classes[c].size(), c ) );
+  sort( order.begin(), order.end() );
+
+  if ( used.size() < k+1 )
+    used.assign( k+1, 0 );
+  for ( size_t i = 0; i < order.size() && !expired(); i++ ) {
+    Color c = order[i].second;
+    const vector<uint32_t>& cls = classes[c];
+    size_t moved = 0;
+    for ( ; moved < cls.size(); moved++ ) {
+      uint32_t v = cls[moved];
+      stamp++;
+      for ( uint64_t p = g.off[v]; p < g.off[v+1]; p++ )
+	used[colors[g.adj[p]]] = stamp;
+      Color d = 1;
+      while ( d <= k && ( d == c || used[d] == stamp ) )
+	d++;
+      if ( d > k )
+	break;
+      colors[v] = d;
+    }
+    if ( moved == cls.size() ) {
+      for ( uint32_t v = 0; v < g.n; v++ )
+	if ( colors[v] > c )
+	  colors[v]--;
+      return true;
+    }
+    for ( size_t j = 0; j < moved; j++ )
+      colors[cls[j]] = c;
+  }
+  return false;
+}
+
+Color Anytime::run ( void ) {
+  vector<Color> colors;
+  Color k = color( g, engine, opt, colors );
+  nRuns++;
+  if ( k == 0 )
+    return 0;
+  publish( colors, k );
+  /// The bound only serves to stop the search: not worth it past the deadline
+  if ( !expired() )
+    lb = clique_bound( g, NULL );
+
+  Options o = opt;
+  bool fresh = true;    /// The local search has not seen this coloring yet
+  for ( unsigned int r = 1; k > lb && !expired(); r++ ) {
+    /// Local search on a new best coloring, then a new seed that must beat it
+    while ( fresh && k > lb && !expired() && eliminate( colors, k ) ) {
+      k--;
+      nElim++;
+      publish( colors, k );
+    }
+    fresh = false;
+    if ( k <= lb || expired() )
+      break;
+    o.seed   = opt.seed + r;
+    o.cutoff = k-1;
+    vector<Color> next;
+    Color kn = color( g, engine, o, next );
+    nRuns++;
+    if ( kn > 0 && kn < k ) {
+      k = kn;
+      colors.swap( next );
+      publish( colors, k );
+      fresh = true;
+    }
+  }
+  return bestK;
+}
+
+} // namespace rlf
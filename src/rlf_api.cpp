@@ -0,0 +1,164 @@
+#include <cstring>
+
+#include <algorithm>
+using std::binary_search;
+using std::sort;
+using std::unique;
+
+#include <ctime>
+
+#include "rlf.hpp"
+#include "rlf_anytime.hpp"
+#include "rlf_complement.hpp"
+#include "rlf_parallel.hpp"
+#include "rlf_small.hpp"
+
+namespace rlf {
+
+static const char* ENGINE_NAMES[NUM_ENGINES] = { "rlf", "plus", "lazy", "adaptive", "dsatur", "jp" };
+
+Engine engine_from_name ( const char* s ) {
+  for ( int e = 0; e < NUM_ENGINES; e++ )
+    if ( strcmp( s, ENGINE_NAMES[e] ) == 0 )
+      return Engine(e);
+  return NUM_ENGINES;
+}
+
+const char* engine_name ( Engine e ) {
+  return ( e < NUM_ENGINES ) ? ENGINE_NAMES[e] : "unknown";
+}
+
+uint64_t clock_ns ( void ) {
+  struct timespec t;
+  clock_gettime( CLOCK_MONOTONIC, &t );
+  return uint64_t(t.tv_sec) * 1000000000ULL + uint64_t(t.tv_nsec);
+}
+
+// threads_unused() follows the choices of color_plus() and color_adaptive(),
+// in their order: only the structure of arrays layout is shared by threads
+const char* threads_unused ( const CsrGraph& g, Engine e, const Options& opt ) {
+  if ( opt.threads <= 1 || e == JP )
+    return NULL;
+  if ( e != PLUS && e != ADAPTIVE )
+    return "the engine runs in one thread (threads: plus, adaptive, jp)";
+  if ( g.n <= SMALL_MAX )
+    return "graphs of at most 512 vertices run on the small engine";
+  if ( use_complement( g, opt, e == PLUS ? 0.5 : 0.7 ) )
+    return "the complement layout runs in one thread";
+  if ( opt.compress )
+    return "the compressed layout runs in one thread";
+  if ( opt.hybrid )
+    return "the hybrid layout runs in one thread";
+  if ( 2*g.m < PARALLEL_MIN_WORK && g.n < PARALLEL_MIN_WORK )
+    return "no step reaches 65536 adjacency entries";
+  return NULL;
+}
+
+Color first_fit ( const CsrGraph& g, vector<Color>& colors ) {
+  Color k = 0;
+  for ( uint32_t v = 0; v < g.n; v++ )
+    if ( colors[v] > k )
+      k = colors[v];
+  vector<uint32_t> used( k + g.n + 2, 0 );
+  for ( uint32_t v = 0; v < g.n; v++ ) {
+    if ( colors[v] != 0 )
+      continue;
+    for ( uint64_t p = g.off[v]; p < g.off[v+1]; p++ )
+      used[colors[g.adj[p]]] = v+1;
+    Color c = 1;
+    while ( used[c] == v+1 )
+      c++;
+    colors[v] = c;
+    if ( c > k )
+      k = c;
+  }
+  return k;
+}
+
+Color color ( const CsrGraph& g, Engine e, const Options& opt, vector<Color>& colors ) {
+  if ( g.n == 0 ) {
+    colors.clear();
+    return 0;
+  }
+  if ( opt.timeLimit > 0 ) {
+    Anytime A( g, e, opt );
+    if ( A.run() == 0 )
+      return 0;
+    return A.best( colors );
+  }
+  if ( opt.order != ORDER_NONE ) {
+    /// Color the relabeled graph, then map the colors back
+    vector<uint32_t> perm;
+    vertex_order( g, opt.order, perm );
+    CsrGraph h;
+    permute_graph( g, perm, h );
+    Options o = opt;
+    o.order = ORDER_NONE;
+    vector<Color> hc;
+    Color k = color( h, e, o, hc );
+    if ( k == 0 )
+      return 0;
+    colors.resize( g.n );
+    for ( uint32_t i = 0; i < g.n; i++ )
+      colors[perm[i]] = hc[i];
+    return k;
+  }
+  switch ( e ) {
+  case RLF:      return color_rlf      ( g, opt, colors );
+  case PLUS:     return color_plus     ( g, opt, colors );
+  case LAZY:     return color_lazy     ( g, opt, colors );
+  case ADAPTIVE: return color_adaptive ( g, opt, colors );
+  case DSATUR:   return color_dsatur   ( g, opt, colors );
+  case JP:       return color_jp       ( g, opt, colors );
+  default:       return 0;
+  }
+}
+
+bool graph_from_csr ( CsrGraph& g, uint32_t n, const uint64_t* off, const uint32_t* adj ) {
+  for ( uint32_t v = 0; v < n; v++ ) {
+    if ( off[v+1] < off[v] )
+      return false;
+    for ( uint64_t p = off[v]; p < off[v+1]; p++ )
+      if ( adj[p] >= n )
+	return false;
+  }
+  /// Sorted lists without loops nor duplicates
+  g.n = n;
+  g.offsets.assign( n+1, 0 );
+  g.neighbors.resize( off[n] - off[0] );
+  uint64_t k = 0;
+  for ( uint32_t v = 0; v < n; v++ ) {
+    uint64_t b = k;
+    for ( uint64_t p = off[v]; p < off[v+1]; p++ )
+      if ( adj[p] != v )
+	g.neighbors[k++] = adj[p];
+    sort( g.neighbors.begin()+b, g.neighbors.begin()+k );
+    k = unique( g.neighbors.begin()+b, g.neighbors.begin()+k ) - g.neighbors.begin();
+    g.offsets[v+1] = k;
+  }
+  g.neighbors.resize( k );
+  g.m = k/2;
+  g.attach();
+  /// Every edge in both directions
+  for ( uint32_t v = 0; v < n; v++ )
+    for ( uint64_t p = g.off[v]; p < g.off[v+1]; p++ ) {
+      uint32_t w = g.adj[p];
+      if ( !binary_search( g.adj + g.off[w], g.adj + g.off[w+1], v ) )
+	return false;
+    }
+  return true;
+}
+
+bool graph_from_edges ( CsrGraph& g, uint32_t n, const uint32_t* edges, uint64_t m ) {
+  CsrEdgeList es;
+  es.reserve( m );
+  for ( uint64_t k = 0; k < m; k++ ) {
+    if ( edges[2*k] >= n || edges[2*k+1] >= n )
+      return false;
+    es.push_back( CsrEdge( edges[2*k], edges[2*k+1] ) );
+  }
+  csr_from_edges( g, n, es );
+  return true;
+}
+
+} // namespace rlf
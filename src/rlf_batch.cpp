@@ -0,0 +1,91 @@
+#include <atomic>
+using std::atomic;
+
+#include "rlf.hpp"
+#include "rlf_small.hpp"
+#include "thread_pool.hpp"
+
+namespace rlf {
+
+/// Graphs claimed at a time by a thread of a batch
+static const size_t BATCH_CHUNK = 64;
+
+///------------------------------------------------------------------------------------------
+/// Scratch of a batch thread, kept from one graph to the next: the offsets
+/// of the current graph rebased to its first neighbor (the neighbors are used
+/// in place), and the colors of the engines that return a vector.
+struct BatchScratch {
+  BatchScratch ( void ) : vertices(0), failed(0) {}
+
+  vector<uint64_t> off;
+  vector<Color>    colors;
+  uint64_t         vertices;
+  size_t           failed;
+};
+
+/// Color graph i of the batch
+static Color color_one ( const GraphBatch& b, size_t i, Engine e, const Options& opt, Color* colors,
+			 BatchScratch& s ) {
+  uint32_t        n   = uint32_t( b.first[i+1] - b.first[i] );
+  const uint64_t* off = b.off + b.first[i];
+  Color*          c   = colors + b.first[i];
+  s.vertices += n;
+  if ( n == 0 )
+    return 0;
+  if ( n <= SMALL_MAX && opt.order == ORDER_NONE && opt.timeLimit <= 0 )
+    switch ( e ) {
+    case PLUS:     return color_small< StaticSelection, CountedU >( n, off, b.adj, opt, c );
+    case LAZY:     return color_small< StaticSelection, ScannedU >( n, off, b.adj, opt, c );
+    case ADAPTIVE: return color_small< DensitySelection, CountedU >( n, off, b.adj, opt, c );
+    default:       break;
+    }
+
+  /// A view of the graph on the batch arrays
+  s.off.resize( n+1 );
+  for ( uint32_t v = 0; v <= n; v++ )
+    s.off[v] = off[v] - off[0];
+  CsrGraph g;
+  g.n   = n;
+  g.m   = s.off[n] / 2;
+  g.off = &s.off[0];
+  g.adj = b.adj + off[0];
+  Color k = color( g, e, opt, s.colors );
+  for ( uint32_t v = 0; v < n && k > 0; v++ )
+    c[v] = s.colors[v];
+  return k;
+}
+
+///------------------------------------------------------------------------------------------
+size_t color_batch ( const GraphBatch& b, Engine e, const Options& opt, Color* colors, Color* k,
+		     BatchStats* stats ) {
+  uint64_t t0 = clock_ns();
+  Options  o1 = opt;
+  o1.threads = 1;
+  WorkTeam             team ( opt.threads );
+  vector<BatchScratch> scratch( team.size() );
+  atomic<size_t>       at( 0 );
+  team.run( [&] ( unsigned int t ) {
+      BatchScratch& s = scratch[t];
+      for ( size_t a; ( a = at.fetch_add( BATCH_CHUNK ) ) < b.graphs; )
+	for ( size_t i = a; i < b.graphs && i < a + BATCH_CHUNK; i++ ) {
+	  Color x = color_one( b, i, e, o1, colors, s );
+	  if ( x == 0 && b.first[i+1] > b.first[i] )
+	    s.failed++;
+	  if ( k != NULL )
+	    k[i] = x;
+	}
+    } );
+
+  BatchStats st;
+  st.graphs = b.graphs;
+  for ( size_t t = 0; t < scratch.size(); t++ ) {
+    st.vertices += scratch[t].vertices;
+    st.failed   += scratch[t].failed;
+  }
+  st.seconds = ( clock_ns() - t0 ) / 1E9;
+  if ( stats != NULL )
+    *stats = st;
+  return st.graphs - st.failed;
+}
+
+} // namespace rlf
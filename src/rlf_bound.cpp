@@ -0,0 +1,130 @@
+#include <algorithm>
+using std::sort;
+using std::binary_search;
+
+#include "rlf.hpp"
+
+namespace rlf {
+
+/// Start vertices tried, by decreasing degree (greedy, and also with the bitsets)
+static const size_t BOUND_STARTS = 32;
+static const size_t BOUND_BITSET_STARTS = 8;
+
+/// Largest neighborhood copied into a bitset matrix
+static const uint32_t BOUND_BITSET = 4096;
+
+struct ByDegree {
+  const CsrGraph& g;
+  explicit ByDegree ( const CsrGraph& g0 ) : g(g0) {}
+  bool operator() ( uint32_t a, uint32_t b ) const {
+    return g.degree(a) > g.degree(b) || ( g.degree(a) == g.degree(b) && a < b );
+  }
+};
+
+static inline bool adjacent ( const CsrGraph& g, uint32_t a, uint32_t b ) {
+  return binary_search( g.adj + g.off[a], g.adj + g.off[a+1], b );
+}
+
+///------------------------------------------------------------------------------------------
+/// Greedy clique from s: the neighbors of s by decreasing degree join when
+/// they are adjacent to all the members so far
+static void greedy_clique ( const CsrGraph& g, uint32_t s, vector<uint32_t>& nb, vector<uint32_t>& q ) {
+  nb.assign( g.adj + g.off[s], g.adj + g.off[s+1] );
+  sort( nb.begin(), nb.end(), ByDegree( g ) );
+  q.assign( 1, s );
+  for ( size_t i = 0; i < nb.size(); i++ ) {
+    if ( g.degree( nb[i] ) < q.size() )
+      break;
+    size_t j = 1;
+    while ( j < q.size() && adjacent( g, nb[i], q[j] ) )
+      j++;
+    if ( j == q.size() )
+      q.push_back( nb[i] );
+  }
+}
+
+/// Clique from s on the bitset matrix of its neighborhood: every step keeps
+/// the candidate adjacent to most of the others. 'local' maps the vertices
+/// to their rows (-1 outside the neighborhood) and is left all -1.
+static void bitset_clique ( const CsrGraph& g, uint32_t s, vector<int32_t>& local,
+			    vector<uint64_t>& rows, vector<uint64_t>& cand, vector<uint32_t>& q ) {
+  uint32_t        d  = g.degree( s );
+  const uint32_t* nb = g.adj + g.off[s];
+  size_t          w  = ( d + 63 ) / 64;
+  for ( uint32_t i = 0; i < d; i++ )
+    local[nb[i]] = int32_t(i);
+  rows.assign( size_t(d) * w, 0 );
+  for ( uint32_t i = 0; i < d; i++ ) {
+    uint64_t* row = &rows[size_t(i) * w];
+    for ( uint64_t p = g.off[nb[i]]; p < g.off[nb[i]+1]; p++ ) {
+      int32_t j = local[g.adj[p]];
+      if ( j >= 0 )
+	row[j >> 6] |= uint64_t(1) << ( j & 63 );
+    }
+  }
+  for ( uint32_t i = 0; i < d; i++ )
+    local[nb[i]] = -1;
+
+  cand.assign( w, ~uint64_t(0) );
+  if ( d & 63 )
+    cand[w-1] = ( uint64_t(1) << ( d & 63 ) ) - 1;
+  q.assign( 1, s );
+  for ( ;; ) {
+    int64_t best = -1, bestCount = -1;
+    for ( size_t x = 0; x < w; x++ )
+      for ( uint64_t bits = cand[x]; bits != 0; bits &= bits - 1 ) {
+	size_t          i   = x * 64 + __builtin_ctzll( bits );
+	const uint64_t* row = &rows[i * w];
+	int64_t         c   = 0;
+	for ( size_t y = 0; y < w; y++ )
+	  c += __builtin_popcountll( cand[y] & row[y] );
+	if ( c > bestCount ) {
+	  bestCount = c;
+	  best      = int64_t(i);
+	}
+      }
+    if ( best < 0 )
+      break;
+    q.push_back( nb[best] );
+    const uint64_t* row = &rows[size_t(best) * w];
+    for ( size_t y = 0; y < w; y++ )
+      cand[y] &= row[y];
+  }
+}
+
+Color clique_bound ( const CsrGraph& g, vector<uint32_t>* clique ) {
+  vector<uint32_t> best;
+  if ( g.n > 0 )
+    best.assign( 1, 0 );
+
+  /// The vertices of highest degree, first
+  vector<uint32_t> start( g.n );
+  for ( uint32_t v = 0; v < g.n; v++ )
+    start[v] = v;
+  size_t k = std::min( size_t(g.n), BOUND_STARTS );
+  std::partial_sort( start.begin(), start.begin() + k, start.end(), ByDegree( g ) );
+
+  vector<uint32_t> nb, q;
+  vector<int32_t>  local;
+  vector<uint64_t> rows, cand;
+  for ( size_t i = 0; i < k; i++ ) {
+    uint32_t s = start[i];
+    if ( g.degree( s ) < best.size() )
+      break;
+    greedy_clique( g, s, nb, q );
+    if ( q.size() > best.size() )
+      best.swap( q );
+    if ( i < BOUND_BITSET_STARTS && g.degree( s ) <= BOUND_BITSET ) {
+      if ( local.empty() )
+	local.assign( g.n, -1 );
+      bitset_clique( g, s, local, rows, cand, q );
+      if ( q.size() > best.size() )
+	best.swap( q );
+    }
+  }
+  if ( clique != NULL )
+    clique->swap( best );
+  return Color( clique != NULL ? clique->size() : best.size() );
+}
+
+} // namespace rlf
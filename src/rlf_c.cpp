@@ -0,0 +1,123 @@
+#include <new>
+
+#include "rlf.h"
+#include "rlf.hpp"
+
+/// The opaque C handle is just a CsrGraph
+struct rlf_graph : public CsrGraph {};
+
+extern "C" {
+
+void rlf_options_init ( rlf_options* opt ) {
+  rlf::Options o;
+  opt->seed  = o.seed;
+  opt->dd    = o.dd;
+  opt->order = o.order;
+  opt->time_limit = o.timeLimit;
+  opt->threads    = o.threads;
+  opt->complement = o.complement;
+  opt->compress   = o.compress;
+  opt->hybrid     = o.hybrid;
+}
+
+/// No exception crosses the C interface: failures (bad_alloc included) are
+/// returned as NULL or -1
+
+rlf_graph* rlf_graph_from_csr ( uint32_t n, const uint64_t* off, const uint32_t* adj ) {
+  rlf_graph* g = new (std::nothrow) rlf_graph;
+  if ( g == NULL )
+    return NULL;
+  try {
+    if ( rlf::graph_from_csr( *g, n, off, adj ) )
+      return g;
+  } catch ( ... ) {
+  }
+  delete g;
+  return NULL;
+}
+
+rlf_graph* rlf_graph_from_edges ( uint32_t n, const uint32_t* edges, uint64_t m ) {
+  rlf_graph* g = new (std::nothrow) rlf_graph;
+  if ( g == NULL )
+    return NULL;
+  try {
+    if ( rlf::graph_from_edges( *g, n, edges, m ) )
+      return g;
+  } catch ( ... ) {
+  }
+  delete g;
+  return NULL;
+}
+
+void rlf_graph_free ( rlf_graph* g ) {
+  delete g;
+}
+
+uint32_t rlf_graph_num_vertices ( const rlf_graph* g ) {
+  return g->n;
+}
+
+/// C options to C++ ones; false if invalid
+static bool to_options ( const rlf_options* opt, rlf::Options& o ) {
+  if ( opt != NULL ) {
+    if ( opt->order < 0 || opt->order >= NUM_ORDERS || opt->complement < -1 || opt->complement > 1 )
+      return false;
+    o.seed  = opt->seed;
+    o.dd    = opt->dd;
+    o.order = GraphOrder(opt->order);
+    o.timeLimit = opt->time_limit;
+    o.threads    = opt->threads;
+    o.complement = opt->complement;
+    o.compress   = opt->compress != 0;
+    o.hybrid     = opt->hybrid != 0;
+  }
+  return true;
+}
+
+int rlf_color ( const rlf_graph* g, int engine, const rlf_options* opt, uint32_t* colors ) {
+  rlf::Options o;
+  if ( engine < 0 || engine >= rlf::NUM_ENGINES || !to_options( opt, o ) )
+    return -1;
+
+  try {
+    vector<rlf::Color> cs;
+    rlf::Color k = rlf::color( *g, rlf::Engine(engine), o, cs );
+    if ( k == 0 && g->n > 0 )
+      return -1;
+    for ( uint32_t v = 0; v < g->n; v++ )
+      colors[v] = cs[v];
+    return int(k);
+  } catch ( ... ) {
+    return -1;
+  }
+}
+
+int rlf_recolor ( const rlf_graph* g, const uint32_t* added, uint64_t na,
+		  const uint32_t* removed, uint64_t nr, int engine, const rlf_options* opt,
+		  unsigned int tolerance, uint32_t* colors ) {
+  rlf::RecolorOptions ro;
+  if ( engine < 0 || engine >= rlf::NUM_ENGINES || !to_options( opt, ro.opt ) )
+    return -1;
+  ro.engine    = rlf::Engine(engine);
+  ro.tolerance = tolerance;
+
+  try {
+    rlf::EdgeDelta delta;
+    for ( uint64_t k = 0; k < na; k++ )
+      delta.added.push_back( CsrEdge( added[2*k], added[2*k+1] ) );
+    for ( uint64_t k = 0; k < nr; k++ )
+      delta.removed.push_back( CsrEdge( removed[2*k], removed[2*k+1] ) );
+
+    vector<rlf::Color> cs( colors, colors + g->n );
+    rlf::Color k = rlf::recolor( *g, delta, ro, cs, NULL );
+    if ( k == 0 && g->n > 0 )
+      return -1;
+    for ( uint32_t v = 0; v < g->n; v++ )
+      colors[v] = cs[v];
+    return int(k);
+  } catch ( ... ) {
+    return -1;
+  }
+}
+
+}
@@ -0,0 +1,291 @@
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+using std::nth_element;
+using std::sort;
+
+#include "rlf.hpp"
+
+namespace rlf {
+
+///------------------------------------------------------------------------------------------
+/// Sequential reader of a sparse binary file (.csr): the header and the
+/// offsets stay in memory, the neighbor section is read from the start in
+/// large blocks at every pass, and the lists are handed out in vertex order.
+class CsrStream {
+public:
+  CsrStream ( void ) : fp(NULL), n(0), m(0), varint(false), start(0), bytes(0) {}
+  ~CsrStream () { if ( fp != NULL ) fclose( fp ); }
+
+  /// Open the file and read the offsets; false (and the reason printed) if not valid
+  bool open ( const char* name, size_t block ) {
+    fp = fopen( name, "rb" );
+    if ( fp == NULL ) {
+      printf("ERROR: Cannot open infile %s\n", name);
+      return false;
+    }
+    CsrHeader h;
+    if ( fread( &h, sizeof(h), 1, fp ) != 1 || memcmp( h.magic, CSR_MAGIC, sizeof(CSR_MAGIC) ) != 0
+	 || h.version != CSR_VERSION || h.n > UINT32_MAX ) {
+      printf("ERROR: Not a sparse binary (.csr) file %s\n", name);
+      return false;
+    }
+    n      = uint32_t(h.n);
+    m      = h.m;
+    varint = ( h.flags & CSR_VARINT ) != 0;
+    off.resize( n+1 );
+    if ( fread( &off[0], sizeof(uint64_t), n+1, fp ) != n+1 ) {
+      printf("ERROR: Corrupted offsets %s\n", name);
+      return false;
+    }
+    start = sizeof(h) + ( uint64_t(n)+1 ) * sizeof(uint64_t);
+    /// Offsets from 0, never decreasing, within the neighbor section and the file
+    struct stat st;
+    bool ok = fstat( fileno( fp ), &st ) == 0 && uint64_t(st.st_size) >= start
+      && h.adjBytes <= uint64_t(st.st_size) - start && off[0] == 0
+      && off[n] <= h.adjBytes / ( varint ? 1 : sizeof(uint32_t) );
+    for ( uint32_t v = 0; ok && v < n; v++ )
+      ok = off[v] <= off[v+1];
+    if ( !ok ) {
+      printf("ERROR: Corrupted offsets %s\n", name);
+      return false;
+    }
+    buf.resize( ( block + 7 ) / 8 );
+    posix_fadvise( fileno( fp ), 0, 0, POSIX_FADV_SEQUENTIAL );
+    return true;
+  }
+
+  /// Length in entries of the list of v (raw files only)
+  inline uint64_t length ( uint32_t v ) const { return off[v+1] - off[v]; }
+  inline bool     raw    ( void )       const { return !varint; }
+
+  /// One pass over the file: f(v, list, length) for every v with need(v)
+  template <class Need, class F>
+  bool pass ( Need need, F f ) {
+    if ( fseeko( fp, off_t(start), SEEK_SET ) != 0 )
+      return false;
+    size_t   unit = varint ? 1 : sizeof(uint32_t);
+    uint64_t lo = 0, hi = 0;   /// Section bytes held in buf
+    unsigned char* b = (unsigned char*) &buf[0];
+    for ( uint32_t v = 0; v < n; v++ ) {
+      uint64_t a = off[v] * unit, e = off[v+1] * unit;
+      if ( e > hi ) {
+	/// Keep the tail from the list of v, then fill the block
+	memmove( b, b + ( a - lo ), size_t( hi - a ) );
+	lo = a;
+	if ( e - lo > buf.size() * 8 ) {
+	  vector<uint64_t> wide( size_t( e - lo + 7 ) / 8 );
+	  memcpy( &wide[0], b, size_t( hi - lo ) );
+	  buf.swap( wide );
+	  b = (unsigned char*) &buf[0];
+	}
+	size_t want = buf.size() * 8 - size_t( hi - lo );
+	size_t got  = fread( b + ( hi - lo ), 1, want, fp );
+	bytes += got;
+	hi    += got;
+	if ( e > hi )
+	  return false;
+      }
+      if ( !need( v ) )
+	continue;
+      const unsigned char* p = b + ( a - lo );
+      if ( !varint ) {
+	const uint32_t* l = (const uint32_t*) p;
+	size_t          k = size_t( off[v+1] - off[v] );
+	for ( size_t i = 0; i < k; i++ )
+	  if ( l[i] >= n )
+	    return corrupted( v );
+	f( v, l, k );
+	continue;
+      }
+      list.clear();
+      const unsigned char* q = b + ( e - lo );
+      uint32_t last = 0;
+      while ( p < q ) {
+	uint32_t x = 0;
+	int      s = 0;
+	while ( p < q && ( *p & 0x80 ) && s < 28 ) {
+	  x |= uint32_t(*p++ & 0x7F) << s;
+	  s += 7;
+	}
+	if ( p == q || ( *p & 0x80 ) )
+	  return corrupted( v );
+	x |= uint32_t(*p++) << s;
+	last += x;
+	if ( last >= n )
+	  return corrupted( v );
+	list.push_back( last );
+      }
+      f( v, list.empty() ? NULL : &list[0], list.size() );
+    }
+    return true;
+  }
+
+private:
+  bool corrupted ( uint32_t v ) {
+    printf("ERROR: Corrupted neighbors of vertex %u\n", v);
+    return false;
+  }
+
+public:
+  FILE*            fp;
+  uint32_t         n;
+  uint64_t         m;
+  bool             varint;
+  uint64_t         start;  /// File position of the neighbor section
+  uint64_t         bytes;  /// Bytes read so far
+  vector<uint64_t> off;
+  vector<uint64_t> buf;    /// Block of the neighbor section (8 byte aligned)
+  vector<uint32_t> list;   /// Decoded list (varint files)
+};
+
+///------------------------------------------------------------------------------------------
+/// Semi-external RLF. In memory: the offsets and, per vertex, the color, the
+/// degree among the uncolored vertices, the degree to U and the P/U state.
+/// A class takes at most ExternalOptions::passes passes:
+///
+///  * pass 1 reads the list of the vertex of maximum degree, which opens it;
+///  * every later pass reads the lists of a batch of P vertices, the best by
+///    degree to U (ties to the minimum degree), and of the vertices that
+///    entered U since the previous pass, whose P neighbors gain one degree to
+///    U. The batch then joins the class in that order, skipping the vertices
+///    that left P; batches grow geometrically and their lists are capped by
+///    ExternalOptions::memory;
+///  * the last pass adds the P vertices left in file order.
+///
+/// With batches of one vertex this is RLF with ties by index.
+Color color_external ( const char* file, const ExternalOptions& xopt, vector<Color>& colors,
+		       ExternalStats* stats ) {
+  enum { IN_P = 0, IN_U = 1, COLORED = 2, FRESH = 4, BATCH = 8 };
+  uint64_t t0 = clock_ns();
+  CsrStream S;
+  if ( !S.open( file, xopt.buffer << 20 ) )
+    return 0;
+  uint32_t n = S.n;
+  /// Batch sizes halve back from the last pass: beyond 64 passes the shift
+  /// would exceed the width of size_t
+  unsigned int R = ( xopt.passes < 2 ) ? 2 : ( xopt.passes > 64 ) ? 64 : xopt.passes;
+
+  vector<uint32_t>      deg( n ), du( n, 0 ), len( n );
+  vector<unsigned char> state( n, IN_P );
+  size_t                passes = 0;
+  if ( S.raw() ) {
+    for ( uint32_t v = 0; v < n; v++ )
+      len[v] = uint32_t( S.length( v ) );
+  } else {
+    /// Varint offsets are in bytes: count the lists
+    passes++;
+    if ( !S.pass( [] ( uint32_t ) { return true; },
+		  [&] ( uint32_t v, const uint32_t*, size_t k ) { len[v] = uint32_t(k); } ) )
+      return 0;
+  }
+  for ( uint32_t v = 0; v < n; v++ )
+    deg[v] = len[v];
+
+  colors.assign( n, 0 );
+  uint64_t budget = uint64_t( xopt.memory << 20 ) / sizeof(uint32_t);
+  uint32_t left   = n;
+  Color    c      = 0;
+  vector<uint32_t> P, batch;
+  vector<uint64_t> at( n, 0 );   /// Start of the stored list of a batch vertex
+  vector<uint32_t> pool;
+  size_t           pLive = 0;
+
+  /// v joins the class: its uncolored neighbors lose one degree, those in P move to U
+  auto take = [&] ( uint32_t v, const uint32_t* a, size_t k ) {
+    colors[v] = c;
+    state[v]  = COLORED;
+    left--;
+    pLive--;
+    for ( size_t i = 0; i < k; i++ ) {
+      uint32_t w = a[i];
+      if ( state[w] & COLORED )
+	continue;
+      deg[w]--;
+      if ( ( state[w] & 3 ) == IN_P ) {
+	state[w] = IN_U | FRESH;
+	pLive--;
+      }
+    }
+  };
+  /// Better candidate: higher degree to U, then lower degree, then lower index
+  auto better = [&] ( uint32_t a, uint32_t b ) {
+    return du[a] > du[b] || ( du[a] == du[b] && ( deg[a] < deg[b] || ( deg[a] == deg[b] && a < b ) ) );
+  };
+
+  while ( left > 0 ) {
+    c++;
+    P.clear();
+    for ( uint32_t v = 0; v < n; v++ )
+      if ( !( state[v] & COLORED ) ) {
+	state[v] = IN_P;
+	du[v]    = 0;
+	P.push_back( v );
+      }
+    pLive = P.size();
+
+    for ( unsigned int i = 0; i < R && pLive > 0; i++ ) {
+      bool last = ( i == R-1 );
+      size_t k = 0;
+      for ( size_t j = 0; j < P.size(); j++ )
+	if ( state[P[j]] == IN_P )
+	  P[k++] = P[j];
+      P.resize( k );
+
+      batch.clear();
+      if ( i == 0 ) {
+	uint32_t v = P[0];
+	for ( size_t j = 1; j < P.size(); j++ )
+	  if ( deg[P[j]] > deg[v] )
+	    v = P[j];
+	batch.push_back( v );
+      } else if ( !last ) {
+	size_t want = ( ( P.size() - 1 ) >> ( R-1-i ) ) + 1;
+	nth_element( P.begin(), P.begin() + ( want-1 ), P.end(), better );
+	sort( P.begin(), P.begin() + want, better );
+	uint64_t words = 0;
+	for ( size_t j = 0; j < want && ( j == 0 || words + len[P[j]] <= budget ); j++ ) {
+	  batch.push_back( P[j] );
+	  words += len[P[j]];
+	}
+      }
+      for ( size_t j = 0; j < batch.size(); j++ )
+	state[batch[j]] |= BATCH;
+
+      pool.clear();
+      passes++;
+      bool ok = S.pass( [&] ( uint32_t v ) { return last ? state[v] == IN_P : ( state[v] & ( FRESH | BATCH ) ) != 0; },
+			[&] ( uint32_t v, const uint32_t* a, size_t k ) {
+			  if ( state[v] & FRESH ) {
+			    state[v] &= ~FRESH;
+			    for ( size_t j = 0; j < k; j++ )
+			      du[a[j]] += ( state[a[j]] == IN_P );
+			  } else if ( state[v] & BATCH ) {
+			    at[v] = pool.size();
+			    pool.insert( pool.end(), a, a + k );
+			  } else
+			    take( v, a, k );
+			} );
+      if ( !ok )
+	return 0;
+      for ( size_t j = 0; j < batch.size(); j++ ) {
+	uint32_t v = batch[j];
+	state[v] &= ~BATCH;
+	if ( state[v] == IN_P )
+	  take( v, pool.data() + at[v], len[v] );
+      }
+    }
+  }
+
+  if ( stats != NULL ) {
+    stats->passes  = passes;
+    stats->bytes   = S.bytes;
+    stats->seconds = ( clock_ns() - t0 ) / 1E9;
+  }
+  return c;
+}
+
+} // namespace rlf
@@ -0,0 +1,268 @@
+#include <algorithm>
+using std::sort;
+using std::unique;
+using std::make_heap;
+using std::push_heap;
+using std::pop_heap;
+
+#include "rlf.hpp"
+#include "thread_pool.hpp"
+
+namespace rlf {
+
+/// Refinement rounds of the partitioner, and imbalance allowed (per mille)
+static const int      PART_ROUNDS    = 8;
+static const uint32_t PART_IMBALANCE = 30;
+
+///------------------------------------------------------------------------------------------
+/// Balanced partition: contiguous blocks of the reverse Cuthill-McKee order,
+/// refined by label propagation. A vertex moves to the part holding most of
+/// its neighbors if that part has more of them than its own and stays within
+/// the size cap.
+static void partition_graph ( const CsrGraph& g, uint32_t k, vector<uint32_t>& part ) {
+  vector<uint32_t> perm;
+  vertex_order( g, ORDER_RCM, perm );
+  part.resize( g.n );
+  vector<uint32_t> size( k, 0 );
+  for ( uint32_t i = 0; i < g.n; i++ ) {
+    part[perm[i]] = uint32_t( uint64_t(i) * k / g.n );
+    size[part[perm[i]]]++;
+  }
+  uint32_t cap = uint32_t( ( uint64_t(g.n) * ( 1000 + PART_IMBALANCE ) + uint64_t(k) * 1000 - 1 ) / ( uint64_t(k) * 1000 ) );
+
+  vector<uint32_t> count( k, 0 );
+  vector<uint32_t> touched;
+  for ( int r = 0; r < PART_ROUNDS; r++ ) {
+    uint32_t moved = 0;
+    for ( uint32_t i = 0; i < g.n; i++ ) {
+      uint32_t v = perm[i];
+      touched.clear();
+      for ( uint64_t p = g.off[v]; p < g.off[v+1]; p++ ) {
+	uint32_t q = part[g.adj[p]];
+	if ( count[q]++ == 0 )
+	  touched.push_back( q );
+      }
+      uint32_t best = part[v];
+      for ( size_t j = 0; j < touched.size(); j++ ) {
+	uint32_t q = touched[j];
+	if ( count[q] > count[best] && size[q] < cap )
+	  best = q;
+      }
+      for ( size_t j = 0; j < touched.size(); j++ )
+	count[touched[j]] = 0;
+      if ( best != part[v] ) {
+	size[part[v]]--;
+	size[best]++;
+	part[v] = best;
+	moved++;
+      }
+    }
+    if ( moved == 0 )
+      break;
+  }
+}
+
+///------------------------------------------------------------------------------------------
+/// Candidate of the boundary pass: its degree to U when pushed, the tie key
+/// (larger first) and the vertex (smaller first)
+struct BoundaryPick {
+  uint32_t du, tie, x;
+  BoundaryPick ( uint32_t du0, uint32_t tie0, uint32_t x0 ) : du(du0), tie(tie0), x(x0) {}
+  bool operator< ( const BoundaryPick& b ) const {
+    if ( du != b.du )   return du < b.du;
+    if ( tie != b.tie ) return tie < b.tie;
+    return x > b.x;
+  }
+};
+
+/// RLF on the boundary vertices B, the other vertices being colored already.
+/// Classes are built in color order from 1: P starts with the uncolored
+/// vertices of B with no neighbor of that color, U with the others, then the
+/// class grows as in RLF (maximum degree to U, ties by minimum degree in the
+/// uncolored part of B, or by maximum degree while no P vertex sees U).
+/// Past the colors in use, the classes are plain RLF. The P vertices sit in
+/// a max-heap, pushed again at every gain of degree to U and dropped when
+/// stale, so a selection costs O(log) instead of a scan of P. The degrees in
+/// B of P vertices do not change within a class: their colored neighbors
+/// would have moved them to U.
+static void color_boundary ( const CsrGraph& g, const vector<uint32_t>& B, vector<Color>& colors ) {
+  enum { IN_P, IN_U, COLORED };
+  uint32_t nb = uint32_t( B.size() );
+  vector<uint32_t> id( g.n, UINT32_MAX );
+  for ( uint32_t i = 0; i < nb; i++ )
+    id[B[i]] = i;
+
+  /// Adjacency within B, and the sorted colors fixed around every vertex of B
+  vector<uint64_t> off( nb+1, 0 ), foff( nb+1, 0 );
+  vector<uint32_t> adj, fixed;
+  for ( uint32_t i = 0; i < nb; i++ ) {
+    uint32_t v = B[i];
+    size_t   f = fixed.size();
+    for ( uint64_t p = g.off[v]; p < g.off[v+1]; p++ ) {
+      uint32_t w = g.adj[p];
+      if ( id[w] != UINT32_MAX )
+	adj.push_back( id[w] );
+      else if ( colors[w] != 0 )
+	fixed.push_back( colors[w] );
+    }
+    sort( fixed.begin() + f, fixed.end() );
+    fixed.resize( unique( fixed.begin() + f, fixed.end() ) - fixed.begin() );
+    off[i+1]  = adj.size();
+    foff[i+1] = fixed.size();
+  }
+
+  vector<uint32_t>      dres( nb ), du( nb ), P;
+  vector<BoundaryPick>  heap;
+  vector<unsigned char> state( nb, IN_P );
+  vector<uint64_t>      cursor( foff.begin(), foff.end()-1 );
+  for ( uint32_t i = 0; i < nb; i++ )
+    dres[i] = uint32_t( off[i+1] - off[i] );
+
+  uint32_t left = nb;
+  for ( Color c = 1; left > 0; c++ ) {
+    P.clear();
+    bool blocked = false;
+    for ( uint32_t i = 0; i < nb; i++ ) {
+      if ( state[i] == COLORED )
+	continue;
+      while ( cursor[i] < foff[i+1] && fixed[cursor[i]] < c )
+	cursor[i]++;
+      if ( cursor[i] < foff[i+1] && fixed[cursor[i]] == c ) {
+	state[i] = IN_U;
+	blocked  = true;
+      } else {
+	state[i] = IN_P;
+	P.push_back( i );
+      }
+    }
+    for ( size_t j = 0; j < P.size(); j++ ) {
+      uint32_t x = P[j];
+      du[x] = 0;
+      if ( blocked )
+	for ( uint64_t p = off[x]; p < off[x+1]; p++ )
+	  du[x] += ( state[adj[p]] == IN_U );
+    }
+
+    heap.clear();
+    for ( size_t j = 0; j < P.size(); j++ )
+      heap.push_back( BoundaryPick( du[P[j]], du[P[j]] == 0 ? dres[P[j]] : ~dres[P[j]], P[j] ) );
+    make_heap( heap.begin(), heap.end() );
+
+    while ( !heap.empty() ) {
+      /// Drop the stale entries, then select
+      pop_heap( heap.begin(), heap.end() );
+      BoundaryPick e = heap.back();
+      heap.pop_back();
+      if ( state[e.x] != IN_P || du[e.x] != e.du )
+	continue;
+      uint32_t v = e.x;
+
+      colors[B[v]] = c;
+      state[v]     = COLORED;
+      left--;
+      for ( uint64_t p = off[v]; p < off[v+1]; p++ ) {
+	uint32_t w = adj[p];
+	dres[w]--;
+	if ( state[w] != IN_P )
+	  continue;
+	state[w] = IN_U;
+	for ( uint64_t q = off[w]; q < off[w+1]; q++ ) {
+	  uint32_t x = adj[q];
+	  if ( state[x] == IN_P ) {
+	    du[x]++;
+	    heap.push_back( BoundaryPick( du[x], ~dres[x], x ) );
+	    push_heap( heap.begin(), heap.end() );
+	  }
+	}
+      }
+    }
+  }
+}
+
+///------------------------------------------------------------------------------------------
+Color color_partitioned ( const CsrGraph& g, Engine e, const Options& opt, unsigned int parts,
+			  vector<Color>& colors, PartitionStats* stats ) {
+  PartitionStats st;
+  uint32_t k = ( parts == 0 ) ? 1 : ( parts > g.n ? g.n : parts );
+  colors.assign( g.n, 0 );
+  if ( g.n == 0 )
+    return 0;
+
+  uint64_t t0 = clock_ns();
+  vector<uint32_t> part;
+  partition_graph( g, k, part );
+
+  /// Interior vertices, numbered within their part
+  vector< vector<uint32_t> > inner( k );
+  vector<uint32_t>           local( g.n, UINT32_MAX );
+  vector<uint32_t>           B;
+  for ( uint32_t v = 0; v < g.n; v++ ) {
+    bool in = true;
+    for ( uint64_t p = g.off[v]; p < g.off[v+1]; p++ )
+      if ( part[g.adj[p]] != part[v] ) {
+	in = false;
+	if ( v < g.adj[p] )
+	  st.cut++;
+      }
+    if ( in ) {
+      local[v] = uint32_t( inner[part[v]].size() );
+      inner[part[v]].push_back( v );
+    } else
+      B.push_back( v );
+  }
+  uint64_t t1 = clock_ns();
+
+  /// The interiors are not adjacent to each other: color them at the same time
+  Options          o1 = opt;
+  vector<Color>    kp( k, 0 );
+  o1.threads = 1;
+  {
+    ThreadPool pool( opt.threads );
+    for ( uint32_t q = 0; q < k; q++ ) {
+      if ( inner[q].empty() )
+	continue;
+      pool.push( [&, q] () {
+	  const vector<uint32_t>& in = inner[q];
+	  CsrEdgeList es;
+	  for ( size_t i = 0; i < in.size(); i++ )
+	    for ( uint64_t p = g.off[in[i]]; p < g.off[in[i]+1]; p++ ) {
+	      uint32_t w = g.adj[p];
+	      if ( in[i] < w && local[w] != UINT32_MAX )
+		es.push_back( CsrEdge( uint32_t(i), local[w] ) );
+	    }
+	  CsrGraph      sub;
+	  vector<Color> sc;
+	  csr_from_edges( sub, uint32_t( in.size() ), es );
+	  kp[q] = color( sub, e, o1, sc );
+	  for ( size_t i = 0; i < in.size() && kp[q] > 0; i++ )
+	    colors[in[i]] = sc[i];
+	} );
+    }
+    pool.wait();
+  }
+  for ( uint32_t q = 0; q < k; q++ ) {
+    if ( !inner[q].empty() && kp[q] == 0 )
+      return 0;
+    if ( kp[q] > st.interior )
+      st.interior = kp[q];
+  }
+  uint64_t t2 = clock_ns();
+
+  color_boundary( g, B, colors );
+  Color x = 0;
+  for ( uint32_t v = 0; v < g.n; v++ )
+    if ( colors[v] > x )
+      x = colors[v];
+  uint64_t t3 = clock_ns();
+
+  st.parts           = k;
+  st.boundary        = B.size();
+  st.partSeconds     = ( t1 - t0 ) / 1E9;
+  st.interiorSeconds = ( t2 - t1 ) / 1E9;
+  st.boundarySeconds = ( t3 - t2 ) / 1E9;
+  if ( stats != NULL )
+    *stats = st;
+  return x;
+}
+
+} // namespace rlf
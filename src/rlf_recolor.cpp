@@ -0,0 +1,245 @@
+#include <algorithm>
+using std::binary_search;
+
+#include <unordered_map>
+using std::unordered_map;
+
+#include <unordered_set>
+using std::unordered_set;
+
+#include "rlf.hpp"
+
+namespace rlf {
+
+/// Longest Kempe chain tried, and chains tried per vertex
+static const size_t KEMPE_CHAIN = 256;
+static const size_t KEMPE_TRIES = 64;
+
+static inline uint64_t edge_key ( uint32_t a, uint32_t b ) {
+  return ( a < b ) ? ( uint64_t(a) << 32 | b ) : ( uint64_t(b) << 32 | a );
+}
+
+///------------------------------------------------------------------------------------------
+/// The changed graph, seen through the delta: the neighbors of v are its CSR
+/// neighbors not removed, plus the added ones. Removals apply first, so an
+/// edge both removed and added is present.
+class DeltaGraph {
+public:
+  DeltaGraph ( const CsrGraph& g0, const EdgeDelta& delta ) : g(g0) {
+    unordered_set<uint64_t> added;
+    for ( size_t i = 0; i < delta.added.size(); i++ ) {
+      uint32_t a = delta.added[i].first, b = delta.added[i].second;
+      if ( a != b && added.insert( edge_key( a, b ) ).second && !inCsr( a, b ) ) {
+	extra[a].push_back( b );
+	extra[b].push_back( a );
+      }
+    }
+    for ( size_t i = 0; i < delta.removed.size(); i++ ) {
+      uint64_t e = edge_key( delta.removed[i].first, delta.removed[i].second );
+      if ( added.count( e ) == 0 )
+	removed.insert( e );
+    }
+  }
+
+  /// Neighbors of v in the changed graph
+  void neighbors ( uint32_t v, vector<uint32_t>& out ) const {
+    out.clear();
+    for ( uint64_t p = g.off[v]; p < g.off[v+1]; p++ )
+      if ( removed.empty() || removed.count( edge_key( v, g.adj[p] ) ) == 0 )
+	out.push_back( g.adj[p] );
+    unordered_map< uint32_t, vector<uint32_t> >::const_iterator it = extra.find( v );
+    if ( it != extra.end() )
+      out.insert( out.end(), it->second.begin(), it->second.end() );
+  }
+
+  bool hasEdge ( uint32_t a, uint32_t b ) const {
+    if ( inCsr( a, b ) )
+      return removed.count( edge_key( a, b ) ) == 0;
+    unordered_map< uint32_t, vector<uint32_t> >::const_iterator it = extra.find( a );
+    return it != extra.end() && std::find( it->second.begin(), it->second.end(), b ) != it->second.end();
+  }
+
+  /// Edge list of the changed graph
+  void edges ( CsrEdgeList& es ) const {
+    vector<uint32_t> nb;
+    for ( uint32_t v = 0; v < g.n; v++ ) {
+      neighbors( v, nb );
+      for ( size_t i = 0; i < nb.size(); i++ )
+	if ( v < nb[i] )
+	  es.push_back( CsrEdge( v, nb[i] ) );
+    }
+  }
+
+private:
+  bool inCsr ( uint32_t a, uint32_t b ) const {
+    return binary_search( g.adj + g.off[a], g.adj + g.off[a+1], b );
+  }
+
+  const CsrGraph&                             g;
+  unordered_set<uint64_t>                     removed;
+  unordered_map< uint32_t, vector<uint32_t> > extra;
+};
+
+///------------------------------------------------------------------------------------------
+/// Give v the color a held by its only neighbor w of color a, swapping an
+/// (a,b) Kempe chain from w; the swap must not bring color a next to v.
+static bool kempe ( const DeltaGraph& h, uint32_t v, const vector<uint32_t>& nb,
+		    const vector<uint32_t>& count, vector<Color>& colors ) {
+  Color  k     = Color(count.size() - 1);
+  size_t tries = 0;
+  vector<uint32_t> chain, next;
+  for ( Color a = 1; a <= k; a++ ) {
+    if ( count[a] != 1 )
+      continue;
+    uint32_t w = 0;
+    for ( size_t i = 0; i < nb.size(); i++ )
+      if ( colors[nb[i]] == a )
+	w = nb[i];
+
+    for ( Color b = 1; b <= k && tries < KEMPE_TRIES; b++ ) {
+      if ( b == a )
+	continue;
+      tries++;
+      /// Breadth first visit of the (a,b) chain from w
+      unordered_set<uint32_t> in;
+      chain.assign( 1, w );
+      in.insert( w );
+      bool ok = true;
+      for ( size_t head = 0; ok && head < chain.size(); head++ ) {
+	h.neighbors( chain[head], next );
+	for ( size_t i = 0; i < next.size(); i++ ) {
+	  uint32_t x = next[i];
+	  if ( ( colors[x] == a || colors[x] == b ) && in.insert( x ).second ) {
+	    chain.push_back( x );
+	    if ( chain.size() > KEMPE_CHAIN ) {
+	      ok = false;
+	      break;
+	    }
+	  }
+	}
+      }
+      for ( size_t i = 0; ok && i < nb.size(); i++ )
+	if ( colors[nb[i]] == b && in.count( nb[i] ) > 0 )
+	  ok = false;
+      if ( !ok )
+	continue;
+      for ( size_t i = 0; i < chain.size(); i++ )
+	colors[chain[i]] = ( colors[chain[i]] == a ) ? b : a;
+      colors[v] = a;
+      return true;
+    }
+  }
+  return false;
+}
+
+Color recolor ( const CsrGraph& g, const EdgeDelta& delta, const RecolorOptions& ropt,
+		vector<Color>& colors, RecolorStats* stats ) {
+  RecolorStats st;
+  if ( colors.size() != g.n )
+    return 0;
+  for ( size_t i = 0; i < delta.added.size(); i++ )
+    if ( delta.added[i].first >= g.n || delta.added[i].second >= g.n )
+      return 0;
+  for ( size_t i = 0; i < delta.removed.size(); i++ )
+    if ( delta.removed[i].first >= g.n || delta.removed[i].second >= g.n )
+      return 0;
+
+  DeltaGraph h( g, delta );
+  Color k = 0;
+  for ( uint32_t v = 0; v < g.n; v++ )
+    if ( colors[v] > k )
+      k = colors[v];
+
+  /// Conflicting added edges, and how many of them hit every vertex
+  CsrEdgeList conflicts;
+  unordered_map<uint32_t, uint32_t> hits;
+  for ( size_t i = 0; i < delta.added.size(); i++ ) {
+    uint32_t a = delta.added[i].first, b = delta.added[i].second;
+    if ( a != b && colors[a] == colors[b] && h.hasEdge( a, b ) ) {
+      conflicts.push_back( delta.added[i] );
+      hits[a]++;
+      hits[b]++;
+    }
+  }
+  st.conflicts = conflicts.size();
+
+  /// Uncolor one end of every conflict: the one in more conflicts, else the one of lower degree
+  vector<uint32_t> repair;
+  for ( size_t i = 0; i < conflicts.size(); i++ ) {
+    uint32_t a = conflicts[i].first, b = conflicts[i].second;
+    if ( colors[a] == 0 || colors[b] == 0 || colors[a] != colors[b] )
+      continue;
+    uint32_t x = ( hits[a] > hits[b] || ( hits[a] == hits[b] && g.degree(a) < g.degree(b) ) ) ? a : b;
+    colors[x] = 0;
+    repair.push_back( x );
+  }
+
+  /// Free existing color, else Kempe chain
+  vector<uint32_t> left, nb;
+  vector<uint32_t> count;
+  for ( size_t i = 0; i < repair.size(); i++ ) {
+    uint32_t v = repair[i];
+    h.neighbors( v, nb );
+    count.assign( k+1, 0 );
+    for ( size_t j = 0; j < nb.size(); j++ )
+      count[colors[nb[j]]]++;
+    Color c = 1;
+    while ( c <= k && count[c] > 0 )
+      c++;
+    if ( c <= k ) {
+      colors[v] = c;
+      st.greedy++;
+    } else if ( kempe( h, v, nb, count, colors ) )
+      st.kempe++;
+    else
+      left.push_back( v );
+  }
+
+  /// RLF on the subgraph induced by the vertices left, with new colors
+  if ( !left.empty() ) {
+    unordered_map<uint32_t, uint32_t> local;
+    for ( size_t i = 0; i < left.size(); i++ )
+      local[left[i]] = uint32_t(i);
+    CsrEdgeList es;
+    for ( size_t i = 0; i < left.size(); i++ ) {
+      h.neighbors( left[i], nb );
+      for ( size_t j = 0; j < nb.size(); j++ ) {
+	unordered_map<uint32_t, uint32_t>::iterator it = local.find( nb[j] );
+	if ( it != local.end() && uint32_t(i) < it->second )
+	  es.push_back( CsrEdge( uint32_t(i), it->second ) );
+      }
+    }
+    CsrGraph sub;
+    csr_from_edges( sub, uint32_t(left.size()), es );
+    vector<Color> sc;
+    Color ks = color( sub, ropt.engine, ropt.opt, sc );
+    if ( ks == 0 )
+      return 0;
+    for ( size_t i = 0; i < left.size(); i++ )
+      colors[left[i]] = k + sc[i];
+    st.local = left.size();
+    k += ks;
+
+    if ( ks > ropt.tolerance ) {
+      /// Too many new colors: color the changed graph from scratch, and keep
+      /// the result only if it is not worse than the repair
+      CsrEdgeList all;
+      h.edges( all );
+      CsrGraph full;
+      csr_from_edges( full, g.n, all );
+      vector<Color> fc;
+      Color kf = color( full, ropt.engine, ropt.opt, fc );
+      if ( kf > 0 && kf <= k ) {
+	colors.swap( fc );
+	k       = kf;
+	st.full = true;
+      }
+    }
+  }
+
+  if ( stats != NULL )
+    *stats = st;
+  return k;
+}
+
+} // namespace rlf
@@ -0,0 +1,311 @@
+#include <cstdlib>
+#include <cstring>
+
+#include <immintrin.h>
+
+#include "rlf_simd.hpp"
+
+namespace rlf {
+namespace simd {
+
+///------------------------------------------------------------------------------------------
+/// AVX2: 8 lanes of 32-bit values, keys as 2 x 4 lanes of 64 bits
+__attribute__((target("avx2")))
+static size_t find_ge_avx2 ( const uint32_t* idx, size_t i0, size_t k, const uint32_t* val, uint32_t t ) {
+  size_t i = i0;
+  __m256i tt = _mm256_set1_epi32( int(t) );
+  for ( ; i + 8 <= k; i += 8 ) {
+    __m256i ix = _mm256_loadu_si256( (const __m256i*)(idx + i) );
+    __m256i x  = _mm256_i32gather_epi32( (const int*)val, ix, 4 );
+    __m256i ge = _mm256_cmpeq_epi32( _mm256_max_epu32( x, tt ), x );
+    int mask = _mm256_movemask_ps( _mm256_castsi256_ps( ge ) );
+    if ( mask != 0 )
+      return i + __builtin_ctz( mask );
+  }
+  return find_ge<uint32_t>( idx, i, k, val, t );
+}
+
+/// 64-bit key (hi, ~lo) of 4 lanes, with the sign bit flipped for the signed compare
+__attribute__((target("avx2")))
+static inline __m256i key_avx2 ( __m128i hi, __m128i lo ) {
+  const __m256i sign = _mm256_set1_epi64x( (long long)0x8000000000000000ULL );
+  __m256i h = _mm256_slli_epi64( _mm256_cvtepu32_epi64( hi ), 32 );
+  __m256i l = _mm256_cvtepu32_epi64( _mm_xor_si128( lo, _mm_set1_epi32( -1 ) ) );
+  return _mm256_xor_si256( _mm256_or_si256( h, l ), sign );
+}
+
+__attribute__((target("avx2")))
+static size_t argmax_hi_lo_avx2 ( const uint32_t* idx, size_t k, const uint32_t* hi, const uint32_t* lo ) {
+  /// Best key and its first position, per lane
+  __m256i bk0 = _mm256_set1_epi64x( (long long)0x8000000000000000ULL ), bk1 = bk0;
+  __m256i bp0 = _mm256_setzero_si256(), bp1 = bp0;
+  __m256i p0  = _mm256_set_epi64x( 3, 2, 1, 0 );
+  __m256i p1  = _mm256_set_epi64x( 7, 6, 5, 4 );
+  const __m256i step = _mm256_set1_epi64x( 8 );
+  size_t i = 0;
+  for ( ; i + 8 <= k; i += 8 ) {
+    __m256i ix = _mm256_loadu_si256( (const __m256i*)(idx + i) );
+    __m256i h  = _mm256_i32gather_epi32( (const int*)hi, ix, 4 );
+    __m256i l  = _mm256_i32gather_epi32( (const int*)lo, ix, 4 );
+    __m256i k0 = key_avx2( _mm256_castsi256_si128( h ), _mm256_castsi256_si128( l ) );
+    __m256i k1 = key_avx2( _mm256_extracti128_si256( h, 1 ), _mm256_extracti128_si256( l, 1 ) );
+    __m256i g0 = _mm256_cmpgt_epi64( k0, bk0 );
+    __m256i g1 = _mm256_cmpgt_epi64( k1, bk1 );
+    bk0 = _mm256_blendv_epi8( bk0, k0, g0 );
+    bk1 = _mm256_blendv_epi8( bk1, k1, g1 );
+    bp0 = _mm256_blendv_epi8( bp0, p0, g0 );
+    bp1 = _mm256_blendv_epi8( bp1, p1, g1 );
+    p0  = _mm256_add_epi64( p0, step );
+    p1  = _mm256_add_epi64( p1, step );
+  }
+
+  /// Reduce the lanes: maximum key, then minimum position
+  long long ks[8], ps[8];
+  _mm256_storeu_si256( (__m256i*)ks,     bk0 );
+  _mm256_storeu_si256( (__m256i*)(ks+4), bk1 );
+  _mm256_storeu_si256( (__m256i*)ps,     bp0 );
+  _mm256_storeu_si256( (__m256i*)(ps+4), bp1 );
+  size_t b = 0;
+  if ( i > 0 ) {
+    int l = 0;
+    for ( int j = 1; j < 8; j++ )
+      if ( ks[j] > ks[l] || ( ks[j] == ks[l] && ps[j] < ps[l] ) )
+	l = j;
+    b = size_t(ps[l]);
+  }
+  for ( ; i < k; i++ ) {
+    uint32_t w = idx[i];
+    uint32_t v = idx[b];
+    if ( ( hi[w] > hi[v] ) ||
+	 ( hi[w] == hi[v] && lo[w] < lo[v] ) )
+      b = i;
+  }
+  return b;
+}
+
+///------------------------------------------------------------------------------------------
+/// AVX-512: 16 lanes of 32-bit values, keys as 2 x 8 lanes of 64 bits
+__attribute__((target("avx512f")))
+static size_t find_ge_avx512 ( const uint32_t* idx, size_t i0, size_t k, const uint32_t* val, uint32_t t ) {
+  size_t i = i0;
+  __m512i tt = _mm512_set1_epi32( int(t) );
+  for ( ; i + 16 <= k; i += 16 ) {
+    __m512i ix = _mm512_loadu_si512( (const void*)(idx + i) );
+    __m512i x  = _mm512_i32gather_epi32( ix, (const void*)val, 4 );
+    __mmask16 mask = _mm512_cmpge_epu32_mask( x, tt );
+    if ( mask != 0 )
+      return i + __builtin_ctz( mask );
+  }
+  return find_ge_avx2( idx, i, k, val, t );
+}
+
+/// 64-bit key (hi, ~lo) of 8 lanes
+__attribute__((target("avx512f")))
+static inline __m512i key_avx512 ( __m256i hi, __m256i lo ) {
+  __m512i h = _mm512_slli_epi64( _mm512_cvtepu32_epi64( hi ), 32 );
+  __m512i l = _mm512_cvtepu32_epi64( _mm256_xor_si256( lo, _mm256_set1_epi32( -1 ) ) );
+  return _mm512_or_si512( h, l );
+}
+
+__attribute__((target("avx512f")))
+static size_t argmax_hi_lo_avx512 ( const uint32_t* idx, size_t k, const uint32_t* hi, const uint32_t* lo ) {
+  __m512i bk0 = _mm512_setzero_si512(), bk1 = bk0;
+  __m512i bp0 = _mm512_setzero_si512(), bp1 = bp0;
+  __m512i p0  = _mm512_set_epi64( 7, 6, 5, 4, 3, 2, 1, 0 );
+  __m512i p1  = _mm512_set_epi64( 15, 14, 13, 12, 11, 10, 9, 8 );
+  const __m512i step = _mm512_set1_epi64( 16 );
+  size_t i = 0;
+  for ( ; i + 16 <= k; i += 16 ) {
+    __m512i ix = _mm512_loadu_si512( (const void*)(idx + i) );
+    __m512i h  = _mm512_i32gather_epi32( ix, (const void*)hi, 4 );
+    __m512i l  = _mm512_i32gather_epi32( ix, (const void*)lo, 4 );
+    __m512i k0 = key_avx512( _mm512_castsi512_si256( h ), _mm512_castsi512_si256( l ) );
+    __m512i k1 = key_avx512( _mm512_extracti64x4_epi64( h, 1 ), _mm512_extracti64x4_epi64( l, 1 ) );
+    __mmask8 g0 = _mm512_cmpgt_epu64_mask( k0, bk0 );
+    __mmask8 g1 = _mm512_cmpgt_epu64_mask( k1, bk1 );
+    bk0 = _mm512_mask_blend_epi64( g0, bk0, k0 );
+    bk1 = _mm512_mask_blend_epi64( g1, bk1, k1 );
+    bp0 = _mm512_mask_blend_epi64( g0, bp0, p0 );
+    bp1 = _mm512_mask_blend_epi64( g1, bp1, p1 );
+    p0  = _mm512_add_epi64( p0, step );
+    p1  = _mm512_add_epi64( p1, step );
+  }
+
+  /// Keys are never 0 (lo < 2^32-1), so lanes never updated lose
+  unsigned long long ks[16], ps[16];
+  _mm512_storeu_si512( (void*)ks,      bk0 );
+  _mm512_storeu_si512( (void*)(ks+8),  bk1 );
+  _mm512_storeu_si512( (void*)ps,      bp0 );
+  _mm512_storeu_si512( (void*)(ps+8),  bp1 );
+  size_t b = 0;
+  if ( i > 0 ) {
+    int l = 0;
+    for ( int j = 1; j < 16; j++ )
+      if ( ks[j] > ks[l] || ( ks[j] == ks[l] && ps[j] < ps[l] ) )
+	l = j;
+    b = size_t(ps[l]);
+  }
+  for ( ; i < k; i++ ) {
+    uint32_t w = idx[i];
+    uint32_t v = idx[b];
+    if ( ( hi[w] > hi[v] ) ||
+	 ( hi[w] == hi[v] && lo[w] < lo[v] ) )
+      b = i;
+  }
+  return b;
+}
+
+///------------------------------------------------------------------------------------------
+/// Gap lists
+
+size_t encode_gaps ( const uint32_t* in, size_t k, unsigned char* ctrl, unsigned char* data ) {
+  unsigned char* d    = data;
+  uint32_t       prev = 0;
+  for ( size_t i = 0; i < k; i++ ) {
+    uint32_t x = in[i] - prev;
+    int      l = ( x < (1U << 8) ) ? 1 : ( x < (1U << 16) ) ? 2 : ( x < (1U << 24) ) ? 3 : 4;
+    if ( i % 4 == 0 )
+      ctrl[i/4] = 0;
+    ctrl[i/4] |= (unsigned char)( ( l-1 ) << ( 2 * ( i%4 ) ) );
+    for ( int j = 0; j < l; j++ )
+      *d++ = (unsigned char)( x >> ( 8*j ) );
+    prev = in[i];
+  }
+  return size_t( d - data );
+}
+
+static size_t decode_gaps_scalar ( const unsigned char* ctrl, const unsigned char* data, size_t k,
+				   uint32_t prev, uint32_t* out ) {
+  const unsigned char* d = data;
+  for ( size_t i = 0; i < k; i++ ) {
+    int      l = ( ( ctrl[i/4] >> ( 2 * ( i%4 ) ) ) & 3 ) + 1;
+    uint32_t x = 0;
+    for ( int j = 0; j < l; j++ )
+      x |= uint32_t( d[j] ) << ( 8*j );
+    d   += l;
+    prev += x;
+    out[i] = prev;
+  }
+  return size_t( d - data );
+}
+
+/// Byte shuffle and data length of every control byte
+struct GapTables {
+  GapTables ( void ) {
+    for ( int c = 0; c < 256; c++ ) {
+      int o = 0;
+      for ( int i = 0; i < 4; i++ ) {
+	int l = ( ( c >> ( 2*i ) ) & 3 ) + 1;
+	for ( int j = 0; j < 4; j++ )
+	  shuffle[c][4*i+j] = ( j < l ) ? (signed char)( o+j ) : (signed char)-1;
+	o += l;
+      }
+      length[c] = (unsigned char) o;
+    }
+  }
+  signed char   shuffle[256][16];
+  unsigned char length[256];
+};
+
+static const GapTables GAP_TABLES;
+
+__attribute__((target("ssse3,sse4.1")))
+static size_t decode_gaps_ssse3 ( const unsigned char* ctrl, const unsigned char* data, size_t k,
+				  uint32_t prev, uint32_t* out ) {
+  const unsigned char* d = data;
+  __m128i p = _mm_set1_epi32( int(prev) );
+  size_t  i = 0;
+  for ( ; i + 4 <= k; i += 4 ) {
+    unsigned char c = ctrl[i/4];
+    __m128i x = _mm_shuffle_epi8( _mm_loadu_si128( (const __m128i*)d ),
+				  _mm_loadu_si128( (const __m128i*)GAP_TABLES.shuffle[c] ) );
+    /// Prefix sum of the 4 gaps, on top of the last value
+    x = _mm_add_epi32( x, _mm_slli_si128( x, 4 ) );
+    x = _mm_add_epi32( x, _mm_slli_si128( x, 8 ) );
+    x = _mm_add_epi32( x, p );
+    _mm_storeu_si128( (__m128i*)( out + i ), x );
+    p  = _mm_shuffle_epi32( x, 0xFF );
+    d += GAP_TABLES.length[c];
+  }
+  prev = uint32_t( _mm_cvtsi128_si32( p ) );
+  return size_t( d - data ) + decode_gaps_scalar( ctrl + i/4, d, k-i, prev, out + i );
+}
+
+///------------------------------------------------------------------------------------------
+/// Bitsets
+static uint64_t and_count_scalar ( const uint64_t* a, const uint64_t* b, size_t w ) {
+  uint64_t k = 0;
+  for ( size_t i = 0; i < w; i++ )
+    k += __builtin_popcountll( a[i] & b[i] );
+  return k;
+}
+
+__attribute__((target("popcnt")))
+static uint64_t and_count_popcnt ( const uint64_t* a, const uint64_t* b, size_t w ) {
+  uint64_t k = 0;
+  for ( size_t i = 0; i < w; i++ )
+    k += __builtin_popcountll( a[i] & b[i] );
+  return k;
+}
+
+///------------------------------------------------------------------------------------------
+/// Run-time dispatch
+static Level detect ( void ) {
+  Level l = SCALAR;
+  __builtin_cpu_init();
+  if ( __builtin_cpu_supports( "avx2" ) )
+    l = AVX2;
+  if ( __builtin_cpu_supports( "avx512f" ) )
+    l = AVX512;
+  const char* cap = getenv( "RLF_SIMD" );
+  if ( cap != NULL ) {
+    if ( strcmp( cap, "scalar" ) == 0 )
+      l = SCALAR;
+    else if ( strcmp( cap, "avx2" ) == 0 && l > AVX2 )
+      l = AVX2;
+  }
+  return l;
+}
+
+static const Level LEVEL = detect();
+
+Level level ( void ) {
+  return LEVEL;
+}
+
+const char* level_name ( Level l ) {
+  static const char* names[] = { "scalar", "avx2", "avx512" };
+  return names[l];
+}
+
+size_t find_ge ( const uint32_t* idx, size_t i0, size_t k, const uint32_t* val, uint32_t t ) {
+  switch ( LEVEL ) {
+  case AVX512: return find_ge_avx512( idx, i0, k, val, t );
+  case AVX2:   return find_ge_avx2( idx, i0, k, val, t );
+  default:     return find_ge<uint32_t>( idx, i0, k, val, t );
+  }
+}
+
+size_t argmax_hi_lo ( const uint32_t* idx, size_t k, const uint32_t* hi, const uint32_t* lo ) {
+  switch ( LEVEL ) {
+  case AVX512: return argmax_hi_lo_avx512( idx, k, hi, lo );
+  case AVX2:   return argmax_hi_lo_avx2( idx, k, hi, lo );
+  default:     return argmax_hi_lo<uint32_t>( idx, k, hi, lo );
+  }
+}
+
+size_t decode_gaps ( const unsigned char* ctrl, const unsigned char* data, size_t k,
+		     uint32_t prev, uint32_t* out ) {
+  if ( LEVEL >= AVX2 )
+    return decode_gaps_ssse3( ctrl, data, k, prev, out );
+  return decode_gaps_scalar( ctrl, data, k, prev, out );
+}
+
+uint64_t and_count ( const uint64_t* a, const uint64_t* b, size_t w ) {
+  if ( LEVEL >= AVX2 )
+    return and_count_popcnt( a, b, w );
+  return and_count_scalar( a, b, w );
+}
+
+} // namespace simd
+} // namespace rlf
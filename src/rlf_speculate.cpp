@@ -0,0 +1,113 @@
+#include <thread>
+using std::thread;
+
+#include "rlf_soa.hpp"
+
+namespace rlf {
+
+///------------------------------------------------------------------------------------------
+/// State of a PLUS run, advanced one selection at a time as in
+/// RlfEngine< StaticSelection, CountedU, SoALayout >
+struct PlusRun {
+  PlusRun ( const CsrGraph& g, const Options& opt ) : G(g, opt), rng(opt.seed), nv(g.n) {}
+
+  /// Color v: its neighbors in P move to U, then it leaves the graph
+  inline void take ( uint32_t v, Color c ) {
+    G.setColor( v, c );
+    move_neighbors_to_u<true>( G, v );
+    nv--;
+    G.clearVertex( v );
+    G.removeFromP( v );
+  }
+
+  /// Open class c with a vertex of maximum degree
+  inline void open ( Color c ) { take( G.maxDegree( rng ), c ); }
+
+  /// Add to class c the vertex of P of maximum degree to U, return it
+  inline uint32_t step ( Color c ) {
+    uint32_t v = G.argmaxU();
+    take( v, c );
+    return v;
+  }
+
+  /// Class complete: U becomes P
+  inline void close ( void ) { G.swap<true>(); }
+
+  SoALayout<uint32_t> G;
+  Random              rng;
+  uint32_t            nv;   /// Vertices not colored yet
+};
+
+/// On a copy taken during class c: class c takes the vertices left in P,
+/// then class c+1 is built
+static void build_ahead ( PlusRun* W, Color c ) {
+  vector<uint32_t> rest;
+  for ( SoALayout<uint32_t>::PIter w = W->G.pIter(); w(); ++w )
+    rest.push_back( *w );
+  for ( size_t i = 0; i < rest.size(); i++ )
+    W->take( rest[i], c );
+  W->close();
+  W->open( c+1 );
+  while ( !W->G.empty() )
+    W->step( c+1 );
+  W->close();
+}
+
+Color color_speculative ( const CsrGraph& g, const Options& opt, vector<Color>& colors,
+			  SpeculateStats* stats ) {
+  if ( !SoALayout<uint32_t>::fits( g ) )
+    return 0;
+  uint64_t       t0 = clock_ns();
+  SpeculateStats st;
+  PlusRun        R( g, opt );
+  Color          c = 0;
+  while ( R.nv > 0 ) {
+    c++;
+    R.open( c );
+    PlusRun*         W = NULL;
+    thread           worker;
+    vector<uint32_t> du;   /// Degrees of the U vertices when W was copied
+    while ( !R.G.empty() ) {
+      uint32_t v = R.step( c );
+      if ( W != NULL || R.G.degree( v ) > 0 || R.G.empty() || R.G.uList().empty() )
+	continue;
+      /// v had no edge left: build class c+1 ahead, from here
+      const GraphVector<uint32_t>& U = R.G.uList();
+      for ( size_t i = 0; i < U.size(); i++ )
+	du.push_back( R.G.degree( U[i] ) );
+      W      = new PlusRun( R );
+      worker = thread( build_ahead, W, c );
+      st.tried++;
+    }
+    if ( W == NULL ) {
+      R.close();
+      continue;
+    }
+
+    /// The class built ahead is valid if the rest of class c changed neither
+    /// U (which only grows) nor the degrees of its vertices
+    const GraphVector<uint32_t>& U = R.G.uList();
+    bool valid = ( U.size() == du.size() );
+    for ( size_t i = 0; valid && i < U.size(); i++ )
+      valid = ( R.G.degree( U[i] ) == du[i] );
+    worker.join();
+    if ( valid ) {
+      std::swap( R, *W );
+      c++;
+      st.adopted++;
+    } else
+      R.close();
+    delete W;
+  }
+
+  colors.resize( g.n );
+  for ( uint32_t v = 0; v < g.n; v++ )
+    colors[v] = R.G.color( v );
+  st.classes = c;
+  st.seconds = ( clock_ns() - t0 ) / 1E9;
+  if ( stats != NULL )
+    *stats = st;
+  return c;
+}
+
+} // namespace rlf
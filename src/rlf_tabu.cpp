@@ -0,0 +1,189 @@
+#include <climits>
+
+#include "rlf.hpp"
+#include "rlf_random.hpp"
+
+namespace rlf {
+
+///------------------------------------------------------------------------------------------
+/// TabuCol with k colors (0-based here) on the adjacency of g. gamma[v*k+c]
+/// counts the neighbors of v in class c: the row of a vertex is contiguous,
+/// so that the scan of the moves of a conflicting vertex reads one cache line
+/// or a few, and a move of v updates two entries of every neighbor row.
+class TabuSearch {
+public:
+  TabuSearch ( const CsrGraph& g0, Color k0, vector<Color>& col0, Random& rng0 )
+    : g(g0), k(k0), col(col0), rng(rng0),
+      gamma( size_t(g0.n) * k0, 0 ), tabu( size_t(g0.n) * k0, 0 ),
+      pos( g0.n, NONE ), f(0) {
+    for ( uint32_t v = 0; v < g.n; v++ ) {
+      uint32_t* row = &gamma[size_t(v) * k];
+      for ( uint64_t p = g.off[v]; p < g.off[v+1]; p++ )
+	row[col[g.adj[p]]]++;
+      f += row[col[v]];
+      if ( row[col[v]] > 0 )
+	add( v );
+    }
+    f /= 2;
+  }
+
+  /// Conflicting edges
+  size_t conflicts ( void ) const { return f; }
+
+  /// Move until no conflict is left, for at most 'iterations' moves or until
+  /// the deadline (if not 0); return the moves made
+  size_t run ( size_t iterations, const TabuOptions& topt, uint64_t deadline ) {
+    size_t bestF = f;
+    size_t it    = 0;
+    for ( ; f > 0 && it < iterations; it++ ) {
+      if ( deadline > 0 && ( it & 1023 ) == 0 && clock_ns() >= deadline )
+	break;
+      /// Best non tabu move, or a tabu one that beats the best so far
+      long     bestD = LONG_MAX;
+      uint32_t bv = NONE;
+      Color    bc = 0;
+      uint32_t ties = 0;
+      for ( size_t i = 0; i < conf.size(); i++ ) {
+	uint32_t        v   = conf[i];
+	const uint32_t* row = &gamma[size_t(v) * k];
+	const uint32_t* tb  = &tabu[size_t(v) * k];
+	long            own = row[col[v]];
+	for ( Color c = 0; c < k; c++ ) {
+	  long d = long(row[c]) - own;
+	  if ( c == col[v] || d > bestD )
+	    continue;
+	  if ( tb[c] > it && long(f) + d >= long(bestF) )
+	    continue;
+	  if ( d < bestD ) {
+	    bestD = d;
+	    ties  = 0;
+	  }
+	  if ( rng() % ++ties == 0 ) {
+	    bv = v;
+	    bc = c;
+	  }
+	}
+      }
+      if ( bv == NONE )
+	continue;
+
+      Color old = col[bv];
+      col[bv] = bc;
+      f += bestD;
+      tabu[size_t(bv) * k + old] = uint32_t( it + rng() % topt.tenure + size_t( topt.alpha * conf.size() ) );
+      for ( uint64_t p = g.off[bv]; p < g.off[bv+1]; p++ ) {
+	uint32_t  u   = g.adj[p];
+	uint32_t* row = &gamma[size_t(u) * k];
+	row[old]--;
+	row[bc]++;
+	if ( col[u] == old && row[old] == 0 )
+	  remove( u );
+	else if ( col[u] == bc && row[bc] == 1 )
+	  add( u );
+      }
+      if ( gamma[size_t(bv) * k + bc] > 0 )
+	add( bv );
+      else
+	remove( bv );
+      if ( f < bestF )
+	bestF = f;
+    }
+    return it;
+  }
+
+private:
+  static const uint32_t NONE = UINT32_MAX;
+
+  /// Conflicting vertices, with their positions in 'conf'
+  void add ( uint32_t v ) {
+    if ( pos[v] == NONE ) {
+      pos[v] = uint32_t( conf.size() );
+      conf.push_back( v );
+    }
+  }
+  void remove ( uint32_t v ) {
+    if ( pos[v] != NONE ) {
+      uint32_t last = conf.back();
+      conf[pos[v]] = last;
+      pos[last]    = pos[v];
+      conf.pop_back();
+      pos[v] = NONE;
+    }
+  }
+
+  const CsrGraph&  g;
+  Color            k;
+  vector<Color>&   col;
+  Random&          rng;
+  vector<uint32_t> gamma;   /// Neighbors of every vertex in every class
+  vector<uint32_t> tabu;    /// Iteration until which v may not go back to c
+  vector<uint32_t> conf;
+  vector<uint32_t> pos;
+  size_t           f;
+};
+
+///------------------------------------------------------------------------------------------
+Color tabucol ( const CsrGraph& g, vector<Color>& colors, const TabuOptions& topt,
+		vector<TabuPhase>* phases ) {
+  if ( colors.size() != g.n || g.n == 0 )
+    return 0;
+  Color k = 0;
+  for ( uint32_t v = 0; v < g.n; v++ )
+    if ( colors[v] > k )
+      k = colors[v];
+
+  TabuOptions o = topt;
+  if ( o.tenure == 0 )
+    o.tenure = 1;
+  uint64_t deadline = ( topt.timeLimit > 0 ) ? clock_ns() + uint64_t( topt.timeLimit * 1E9 ) : 0;
+  Random   rng( topt.seed );
+
+  vector<Color>    col( g.n );
+  vector<uint32_t> size( k+1 ), count;
+  while ( k > 1 && k > topt.bound && ( deadline == 0 || clock_ns() < deadline ) ) {
+    uint64_t t0 = clock_ns();
+
+    /// Drop the smallest class: the classes above it move down by one and
+    /// its vertices go to the classes where they have fewest neighbors
+    size.assign( k+1, 0 );
+    for ( uint32_t v = 0; v < g.n; v++ )
+      size[colors[v]]++;
+    Color drop = 1;
+    for ( Color c = 2; c <= k; c++ )
+      if ( size[c] < size[drop] )
+	drop = c;
+    for ( uint32_t v = 0; v < g.n; v++ )
+      col[v] = ( colors[v] > drop ) ? colors[v] - 2 : colors[v] - 1;
+    for ( uint32_t v = 0; v < g.n; v++ ) {
+      if ( colors[v] != drop )
+	continue;
+      count.assign( k-1, 0 );
+      for ( uint64_t p = g.off[v]; p < g.off[v+1]; p++ )
+	if ( colors[g.adj[p]] != drop )
+	  count[col[g.adj[p]]]++;
+      Color best = 0;
+      for ( Color c = 1; c < k-1; c++ )
+	if ( count[c] < count[best] )
+	  best = c;
+      col[v] = best;
+    }
+
+    TabuSearch ts( g, k-1, col, rng );
+    TabuPhase  ph;
+    ph.k          = k-1;
+    ph.conflicts  = ts.conflicts();
+    ph.iterations = ts.run( o.iterations, o, deadline );
+    ph.solved     = ( ts.conflicts() == 0 );
+    ph.seconds    = ( clock_ns() - t0 ) / 1E9;
+    if ( phases != NULL )
+      phases->push_back( ph );
+    if ( !ph.solved )
+      break;
+    k--;
+    for ( uint32_t v = 0; v < g.n; v++ )
+      colors[v] = col[v] + 1;
+  }
+  return k;
+}
+
+} // namespace rlf
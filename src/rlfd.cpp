@@ -0,0 +1,370 @@
+/*
+ *  rlfd: coloring daemon over a Unix domain socket.
+ *
+ *  Graphs are kept loaded in an LRU cache keyed by file path (and checked
+ *  against the file modification time and size), so that repeated jobs on
+ *  the same graph only pay for the coloring.
+ *
+ *  Protocol: one request per line, one reply per line.
+ *
+ *    color <file> [engine=rlf|plus|lazy|adaptive|dsatur|jp] [seed=<s>] [dd=<d>]
+ *          [order=none|degree|rcm|community] [limit=<sec>] [colors=1]
+ *        => ok X(G)=<k> time=<sec> cached=<0|1> [colors=<c_1> ... <c_n>]
+ *    stats
+ *        => ok graphs=<k> bytes=<b> mapped=<b> huge=<b>
+ *    quit
+ *
+ *  Errors are replied as "error <reason>"; a seed, dd or limit that is not
+ *  a whole number (seed) or a finite real >= 0 gives "error bad value <tok>".
+ *
+ *  Requests are served by a pool of threads, one task per request, so that
+ *  a few open connections do not hold all the threads. The requests of one
+ *  connection are served in order.
+ */
+
+#include <iostream>
+using std::cout;
+using std::cerr;
+using std::endl;
+
+#include <sstream>
+using std::istringstream;
+using std::ostringstream;
+
+#include <cerrno>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <csignal>
+#include <ctime>
+
+#include <map>
+using std::map;
+
+#include <mutex>
+using std::mutex;
+using std::lock_guard;
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include "rlf.hpp"
+#include "graph_cache.hpp"
+#include "thread_pool.hpp"
+
+static const char* socket_name = NULL;
+
+static void on_signal ( int ) {
+  if ( socket_name != NULL )
+    unlink( socket_name );
+  _exit( EXIT_SUCCESS );
+}
+
+/// CPU time of the calling thread, in seconds
+static double thread_time ( void ) {
+  struct timespec t;
+  clock_gettime( CLOCK_THREAD_CPUTIME_ID, &t );
+  return t.tv_sec + t.tv_nsec/1E9;
+}
+
+/// Write the whole string
+static bool send_all ( int fd, const string& s ) {
+  size_t k = 0;
+  while ( k < s.size() ) {
+    ssize_t r = write( fd, s.data()+k, s.size()-k );
+    if ( r <= 0 )
+      return false;
+    k += r;
+  }
+  return true;
+}
+
+/// Parse a whole value: a decimal unsigned int, or a finite real >= 0
+static bool parse_uint ( const string& s, unsigned int& x ) {
+  char* end;
+  errno = 0;
+  unsigned long r = strtoul( s.c_str(), &end, 10 );
+  if ( s.empty() || s[0] < '0' || s[0] > '9' || *end != 0 || errno != 0 || r > UINT_MAX )
+    return false;
+  x = (unsigned int) r;
+  return true;
+}
+
+static bool parse_real ( const string& s, double& x ) {
+  char* end;
+  errno = 0;
+  double r = strtod( s.c_str(), &end );
+  if ( s.empty() || *end != 0 || errno != 0 || !std::isfinite( r ) || r < 0 )
+    return false;
+  x = r;
+  return true;
+}
+
+/// Serve one request line, return the reply
+static string serve ( GraphCache& cache, const string& line ) {
+  istringstream in( line );
+  string cmd, file, tok;
+  in >> cmd;
+
+  ostringstream out;
+  if ( cmd == "stats" ) {
+    GraphMemStats ms;
+    graph_memory_stats( ms );
+    out << "ok graphs=" << cache.size() << " bytes=" << cache.bytes()
+	<< " mapped=" << ms.bytes << " huge=" << ms.hugeBytes << "\n";
+    return out.str();
+  }
+  if ( cmd != "color" || !(in >> file) )
+    return "error bad request\n";
+
+  rlf::Engine  engine = rlf::PLUS;
+  rlf::Options opt;
+  bool         print  = false;
+  while ( in >> tok ) {
+    size_t eq = tok.find( '=' );
+    string key = tok.substr( 0, eq );
+    string val = ( eq == string::npos ) ? "" : tok.substr( eq+1 );
+    if ( key == "engine" )
+      engine = rlf::engine_from_name( val.c_str() );
+    else if ( key == "seed" ) {
+      if ( !parse_uint( val, opt.seed ) )
+	return "error bad value " + tok + "\n";
+    }
+    else if ( key == "dd" ) {
+      if ( !parse_real( val, opt.dd ) )
+	return "error bad value " + tok + "\n";
+    }
+    else if ( key == "order" ) {
+      opt.order = order_from_name( val.c_str() );
+      if ( opt.order == NUM_ORDERS )
+	return "error unknown order " + val + "\n";
+    }
+    else if ( key == "limit" ) {
+      if ( !parse_real( val, opt.timeLimit ) )
+	return "error bad value " + tok + "\n";
+    }
+    else if ( key == "colors" )
+      print = ( val == "1" );
+    else
+      return "error unknown option " + key + "\n";
+  }
+  if ( engine == rlf::NUM_ENGINES )
+    return "error unknown engine\n";
+
+  bool hit = false;
+  shared_ptr<const CsrGraph> g = cache.get( file, hit );
+  if ( !g )
+    return "error cannot read " + file + "\n";
+
+  vector<rlf::Color> colors;
+  double t0 = thread_time();
+  rlf::Color k = rlf::color( *g, engine, opt, colors );
+  double t1 = thread_time();
+  if ( k == 0 && g->n > 0 )
+    return "error graph too large for the engine\n";
+
+  out.setf( std::ios_base::fixed, std::ios_base::floatfield );
+  out.precision( 3 );
+  out << "ok X(G)=" << k << " time=" << (t1-t0) << " cached=" << hit;
+  if ( print ) {
+    out << " colors=";
+    for ( size_t v = 0; v < colors.size(); v++ )
+      out << ( v > 0 ? " " : "" ) << colors[v];
+  }
+  out << "\n";
+  return out.str();
+}
+
+///------------------------------------------------------------------------------------------
+/// Event loop: the main thread polls the socket and the connections, and
+/// every complete request line becomes one task of the pool. A connection has
+/// at most one request running, so that its replies keep the order of the
+/// requests; it is not polled meanwhile. A finished task queues its
+/// connection and wakes the loop through a pipe.
+class Server {
+public:
+  Server ( int server0, GraphCache& cache0, unsigned int threads )
+    : server(server0), cache(cache0), pool(threads) {
+    if ( pipe( wake ) != 0 ) {
+      perror( "rlfd" );
+      exit ( EXIT_FAILURE );
+    }
+  }
+
+  void run ( void ) {
+    vector<struct pollfd> fds;
+    for ( ;; ) {
+      fds.clear();
+      add( fds, wake[0] );
+      add( fds, server );
+      for ( map<int,Connection>::iterator it = conns.begin(); it != conns.end(); ++it )
+	if ( !it->second.busy )
+	  add( fds, it->first );
+      if ( poll( &fds[0], fds.size(), -1 ) < 0 )
+	continue;
+
+      if ( fds[0].revents != 0 )
+	finished();
+      if ( fds[1].revents & POLLIN ) {
+	int fd = accept( server, NULL, NULL );
+	if ( fd >= 0 )
+	  conns[fd] = Connection();
+      }
+      for ( size_t i = 2; i < fds.size(); i++ )
+	if ( fds[i].revents != 0 )
+	  receive( fds[i].fd );
+    }
+  }
+
+private:
+  struct Connection {
+    Connection ( void ) : busy(false) {}
+    string buf;    /// Received, not yet served
+    bool   busy;   /// A request is running
+  };
+
+  static void add ( vector<struct pollfd>& fds, int fd ) {
+    struct pollfd p;
+    p.fd      = fd;
+    p.events  = POLLIN;
+    p.revents = 0;
+    fds.push_back( p );
+  }
+
+  /// Read from a connection, serve the complete lines
+  void receive ( int fd ) {
+    char    chunk[4096];
+    ssize_t r = read( fd, chunk, sizeof(chunk) );
+    if ( r <= 0 ) {
+      drop( fd );
+      return;
+    }
+    conns[fd].buf.append( chunk, r );
+    dispatch( fd );
+  }
+
+  /// Queue the next request of an idle connection
+  void dispatch ( int fd ) {
+    Connection& c = conns[fd];
+    size_t nl;
+    while ( !c.busy && (nl = c.buf.find( '\n' )) != string::npos ) {
+      string line = c.buf.substr( 0, nl );
+      c.buf.erase( 0, nl+1 );
+      if ( line == "quit" ) {
+	drop( fd );
+	return;
+      }
+      if ( line.empty() )
+	continue;
+      c.busy = true;
+      pool.push( [this, fd, line] () {
+	  bool ok = send_all( fd, serve( cache, line ) );
+	  {
+	    lock_guard<mutex> guard( lock );
+	    done.push_back( pair<int,bool>( fd, ok ) );
+	  }
+	  char b = 0;
+	  if ( write( wake[1], &b, 1 ) < 0 )
+	    perror( "rlfd" );
+	} );
+    }
+  }
+
+  /// Take back the connections of the finished requests
+  void finished ( void ) {
+    char b[64];
+    if ( read( wake[0], b, sizeof(b) ) < 0 )
+      perror( "rlfd" );
+    vector< pair<int,bool> > ready;
+    {
+      lock_guard<mutex> guard( lock );
+      ready.swap( done );
+    }
+    for ( size_t i = 0; i < ready.size(); i++ ) {
+      int fd = ready[i].first;
+      conns[fd].busy = false;
+      if ( ready[i].second )
+	dispatch( fd );
+      else
+	drop( fd );
+    }
+  }
+
+  void drop ( int fd ) {
+    close( fd );
+    conns.erase( fd );
+  }
+
+  int                       server;
+  GraphCache&               cache;
+  ThreadPool                pool;
+  int                       wake[2];   /// Written by the tasks, read by the loop
+  map<int,Connection>       conns;     /// Used by the loop only
+  mutex                     lock;
+  vector< pair<int,bool> >  done;      /// Finished requests: connection, reply sent
+};
+
+///------------------------------------------------------------------------------------------
+int
+main(int argc, char* argv[])
+{
+  if ( argc < 2 ) {
+    cout << "\n\t usage: rlfd <socket> [-threads <k>] [-cache <graphs>] [-mem <MB>]"
+	 << " [-pages default|huge] [-numa local|interleave]\n\n";
+    exit(-1);
+  }
+
+  unsigned int threads   = ThreadPool::hardware();
+  size_t       maxGraphs = 16;
+  size_t       maxMB     = 0;
+  GraphPages   pages     = PAGES_DEFAULT;
+  GraphNuma    numa      = NUMA_LOCAL;
+  for ( int i = 2; i+1 < argc; i += 2 ) {
+    if ( strcmp( argv[i], "-threads" ) == 0 )
+      threads = atoi( argv[i+1] );
+    else if ( strcmp( argv[i], "-cache" ) == 0 )
+      maxGraphs = atoi( argv[i+1] );
+    else if ( strcmp( argv[i], "-mem" ) == 0 )
+      maxMB = atoi( argv[i+1] );
+    else if ( strcmp( argv[i], "-pages" ) == 0 )
+      pages = pages_from_name( argv[i+1] );
+    else if ( strcmp( argv[i], "-numa" ) == 0 )
+      numa = numa_from_name( argv[i+1] );
+  }
+  if ( pages == NUM_PAGES || numa == NUM_NUMA ) {
+    cerr << "ERROR: unknown memory policy" << endl;
+    exit ( EXIT_FAILURE );
+  }
+  graph_memory_policy( pages, numa );
+
+  struct sockaddr_un addr;
+  memset( &addr, 0, sizeof(addr) );
+  addr.sun_family = AF_UNIX;
+  if ( strlen( argv[1] ) >= sizeof(addr.sun_path) ) {
+    cerr << "ERROR: socket path too long" << endl;
+    exit ( EXIT_FAILURE );
+  }
+  strcpy( addr.sun_path, argv[1] );
+
+  int server = socket( AF_UNIX, SOCK_STREAM, 0 );
+  unlink( argv[1] );
+  if ( server < 0 || bind( server, (struct sockaddr*)&addr, sizeof(addr) ) != 0
+       || listen( server, 64 ) != 0 ) {
+    perror( "rlfd" );
+    exit ( EXIT_FAILURE );
+  }
+  socket_name = argv[1];
+  signal( SIGINT,  on_signal );
+  signal( SIGTERM, on_signal );
+  signal( SIGPIPE, SIG_IGN );
+
+  GraphCache cache( maxGraphs, maxMB << 20 );
+  Server     loop( server, cache, threads );
+  loop.run();
+
+  return EXIT_SUCCESS;
+}
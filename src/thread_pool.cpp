@@ -0,0 +1,111 @@
+#include "thread_pool.hpp"
+
+using std::unique_lock;
+using std::lock_guard;
+
+ThreadPool::ThreadPool ( unsigned int k ) : running(0), stop(false) {
+  if ( k == 0 )
+    k = 1;
+  for ( unsigned int i = 0; i < k; i++ )
+    workers.push_back( thread( &ThreadPool::run, this ) );
+}
+
+ThreadPool::~ThreadPool () {
+  wait();
+  {
+    lock_guard<mutex> guard( lock );
+    stop = true;
+  }
+  ready.notify_all();
+  for ( size_t i = 0; i < workers.size(); i++ )
+    workers[i].join();
+}
+
+unsigned int ThreadPool::hardware ( void ) {
+  unsigned int k = thread::hardware_concurrency();
+  return ( k > 0 ) ? k : 1;
+}
+
+void ThreadPool::push ( const Task& t ) {
+  {
+    lock_guard<mutex> guard( lock );
+    tasks.push_back( t );
+  }
+  ready.notify_one();
+}
+
+void ThreadPool::wait ( void ) {
+  unique_lock<mutex> guard( lock );
+  while ( !tasks.empty() || running > 0 )
+    idle.wait( guard );
+}
+
+void ThreadPool::run ( void ) {
+  unique_lock<mutex> guard( lock );
+  for ( ;; ) {
+    while ( !stop && tasks.empty() )
+      ready.wait( guard );
+    if ( tasks.empty() )
+      return;
+    Task t = tasks.front();
+    tasks.pop_front();
+    running++;
+    guard.unlock();
+    t();
+    guard.lock();
+    running--;
+    idle.notify_all();
+  }
+}
+
+///------------------------------------------------------------------------------------------
+WorkTeam::WorkTeam ( unsigned int k0 ) : k(k0 ? k0 : 1), job(NULL), round(0), pending(0), stop(false) {
+  for ( unsigned int t = 1; t < k; t++ )
+    helpers.push_back( thread( &WorkTeam::help, this, t ) );
+}
+
+WorkTeam::~WorkTeam () {
+  {
+    lock_guard<mutex> guard( lock );
+    stop = true;
+  }
+  start.notify_all();
+  for ( size_t i = 0; i < helpers.size(); i++ )
+    helpers[i].join();
+}
+
+void WorkTeam::run ( const Job& f ) {
+  if ( k == 1 ) {
+    f( 0 );
+    return;
+  }
+  {
+    lock_guard<mutex> guard( lock );
+    job     = &f;
+    pending = k-1;
+    round++;
+  }
+  start.notify_all();
+  f( 0 );
+  unique_lock<mutex> guard( lock );
+  while ( pending > 0 )
+    done.wait( guard );
+}
+
+void WorkTeam::help ( unsigned int t ) {
+  unsigned long seen = 0;
+  unique_lock<mutex> guard( lock );
+  for ( ;; ) {
+    while ( !stop && round == seen )
+      start.wait( guard );
+    if ( stop )
+      return;
+    seen = round;
+    const Job* f = job;
+    guard.unlock();
+    (*f)( t );
+    guard.lock();
+    if ( --pending == 0 )
+      done.notify_one();
+  }
+}
@@ -0,0 +1,61 @@
+#ifndef _MY_CHECK_
+#define _MY_CHECK_
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "rlf.hpp"
+#include "rlf_random.hpp"
+
+///------------------------------------------------------------------------------------------
+/// Helpers of the regression tests (make check): every failed CHECK prints
+/// its place and condition, and the test exits with EXIT_FAILURE.
+static int check_failures = 0;
+
+#define CHECK( c ) do {							\
+    if ( !(c) ) {							\
+      check_failures++;							\
+      printf( "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #c );	\
+    }									\
+  } while ( 0 )
+
+/// Report the test and return its exit status
+inline int check_result ( const char* name ) {
+  if ( check_failures > 0 ) {
+    printf( "%s: %d checks failed\n", name, check_failures );
+    return EXIT_FAILURE;
+  }
+  printf( "%s: ok\n", name );
+  return EXIT_SUCCESS;
+}
+
+/// Random G(n, p), from the generator of the engines
+inline void random_graph ( CsrGraph& g, uint32_t n, double p, unsigned int seed ) {
+  Random      rng( seed );
+  double      t = p * 2147483648.0;   /// rng() is in [0, 2^31)
+  CsrEdgeList es;
+  for ( uint32_t a = 0; a < n; a++ )
+    for ( uint32_t b = a+1; b < n; b++ )
+      if ( rng() < t )
+	es.push_back( CsrEdge( a, b ) );
+  csr_from_edges( g, n, es );
+}
+
+/// Every vertex has a color in 1..k, k is used, no edge joins two vertices of the same color
+inline bool valid_coloring ( const CsrGraph& g, const vector<rlf::Color>& colors, rlf::Color k ) {
+  if ( colors.size() != g.n )
+    return false;
+  rlf::Color top = 0;
+  for ( uint32_t v = 0; v < g.n; v++ ) {
+    if ( colors[v] == 0 || colors[v] > k )
+      return false;
+    if ( colors[v] > top )
+      top = colors[v];
+    for ( uint64_t p = g.off[v]; p < g.off[v+1]; p++ )
+      if ( g.adj[p] != v && colors[g.adj[p]] == colors[v] )
+	return false;
+  }
+  return top == k;
+}
+
+#endif
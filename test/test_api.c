@@ -0,0 +1,116 @@
+/*
+ *  Contracts of the C interface (rlf.h), compiled as C: invalid graphs give
+ *  NULL, invalid calls give -1, and valid ones color every vertex.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "rlf.h"
+
+static int failures = 0;
+
+#define CHECK( c ) do {							\
+    if ( !(c) ) {							\
+      failures++;							\
+      printf( "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #c );	\
+    }									\
+  } while ( 0 )
+
+/* Colors in 1..k, k used, no edge inside a class (edges as pairs) */
+static int valid ( const uint32_t* colors, uint32_t n, int k, const uint32_t* edges, uint64_t m ) {
+  uint32_t top = 0;
+  for ( uint32_t v = 0; v < n; v++ ) {
+    if ( colors[v] == 0 || colors[v] > (uint32_t) k )
+      return 0;
+    if ( colors[v] > top )
+      top = colors[v];
+  }
+  for ( uint64_t e = 0; e < m; e++ )
+    if ( edges[2*e] != edges[2*e+1] && colors[edges[2*e]] == colors[edges[2*e+1]] )
+      return 0;
+  return top == (uint32_t) k;
+}
+
+int main ( void ) {
+  rlf_options opt;
+  rlf_options_init( &opt );
+  CHECK( opt.order == RLF_ORDER_NONE && opt.time_limit == 0.0 );
+  CHECK( opt.threads == 1 && opt.complement == 0 && opt.compress == 0 && opt.hybrid == 0 );
+
+  /* Path 0-1-2 with a self loop on 1: the loop is dropped */
+  uint64_t   off[4]  = { 0, 1, 4, 5 };
+  uint32_t   adj[5]  = { 1, 0, 1, 2, 1 };
+  uint32_t   path[4] = { 0, 1, 1, 2 };
+  uint32_t   colors[8];
+  rlf_graph* g = rlf_graph_from_csr( 3, off, adj );
+  CHECK( g != NULL );
+  if ( g != NULL ) {
+    CHECK( rlf_graph_num_vertices( g ) == 3 );
+    for ( int e = RLF_ENGINE_RLF; e <= RLF_ENGINE_JP; e++ ) {
+      int k = rlf_color( g, e, NULL, colors );
+      CHECK( k == 2 && valid( colors, 3, k, path, 2 ) );
+    }
+    CHECK( rlf_color( g, -1, NULL, colors ) == -1 );
+    CHECK( rlf_color( g, RLF_ENGINE_JP+1, &opt, colors ) == -1 );
+    opt.order = 99;
+    CHECK( rlf_color( g, RLF_ENGINE_PLUS, &opt, colors ) == -1 );
+    opt.order = RLF_ORDER_NONE;
+    opt.complement = 2;
+    CHECK( rlf_color( g, RLF_ENGINE_PLUS, &opt, colors ) == -1 );
+
+    /* Every layout and threads: same graph, same answer */
+    for ( int layout = 0; layout < 5; layout++ ) {
+      rlf_options o;
+      rlf_options_init( &o );
+      o.complement = ( layout == 1 ) ? 1 : -1;
+      o.compress   = ( layout == 2 );
+      o.hybrid     = ( layout == 3 );
+      o.threads    = ( layout == 4 ) ? 3 : 1;
+      int k = rlf_color( g, RLF_ENGINE_PLUS, &o, colors );
+      CHECK( k == 2 && valid( colors, 3, k, path, 2 ) );
+    }
+    opt.complement = 0;
+
+    /* Closing the triangle: the repair needs a third color */
+    uint32_t added[2]    = { 0, 2 };
+    uint32_t triangle[6] = { 0, 1, 1, 2, 0, 2 };
+    int k = rlf_color( g, RLF_ENGINE_PLUS, &opt, colors );
+    CHECK( k == 2 );
+    k = rlf_recolor( g, added, 1, NULL, 0, RLF_ENGINE_PLUS, &opt, 1, colors );
+    CHECK( k == 3 && valid( colors, 3, k, triangle, 3 ) );
+    uint32_t outside[2] = { 0, 3 };
+    CHECK( rlf_recolor( g, outside, 1, NULL, 0, RLF_ENGINE_PLUS, &opt, 1, colors ) == -1 );
+    CHECK( rlf_recolor( g, NULL, 0, NULL, 0, 42, &opt, 1, colors ) == -1 );
+    rlf_graph_free( g );
+  }
+
+  /* Invalid CSR arrays */
+  uint32_t range[5] = { 1, 0, 7, 2, 1 };
+  CHECK( rlf_graph_from_csr( 3, off, range ) == NULL );
+  uint64_t off2[4]  = { 0, 1, 3, 3 };
+  uint32_t asym[3]  = { 1, 0, 2 };
+  CHECK( rlf_graph_from_csr( 3, off2, asym ) == NULL );
+  uint64_t down[4]  = { 0, 3, 1, 5 };
+  CHECK( rlf_graph_from_csr( 3, down, adj ) == NULL );
+
+  /* Edges */
+  uint32_t bad[4] = { 0, 1, 1, 5 };
+  CHECK( rlf_graph_from_edges( 3, bad, 2 ) == NULL );
+  uint32_t c5[12] = { 0, 1, 1, 2, 2, 3, 3, 4, 4, 0, 2, 2 };
+  g = rlf_graph_from_edges( 5, c5, 6 );
+  CHECK( g != NULL );
+  if ( g != NULL ) {
+    int k = rlf_color( g, RLF_ENGINE_DSATUR, NULL, colors );
+    CHECK( k == 3 && valid( colors, 5, k, c5, 6 ) );
+    rlf_graph_free( g );
+  }
+  rlf_graph_free( NULL );
+
+  if ( failures > 0 ) {
+    printf( "test_api: %d checks failed\n", failures );
+    return EXIT_FAILURE;
+  }
+  printf( "test_api: ok\n" );
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,60 @@
+/*
+ *  rlf::color_batch gives every graph of a packed batch the coloring of
+ *  rlf::color on that graph alone, at any thread count.
+ */
+
+#include "check.hpp"
+
+using namespace rlf;
+
+int main ( void ) {
+  /// Graphs of 0 to 200 vertices, and some beyond the small engine
+  vector<CsrGraph*> gs;
+  vector<uint64_t>  first( 1, 0 ), off;
+  vector<uint32_t>  adj;
+  for ( unsigned int i = 0; i < 400; i++ ) {
+    uint32_t n = ( i % 50 == 0 ) ? 600 + i : ( i * 53 ) % 200;
+    CsrGraph* g = new CsrGraph();
+    random_graph( *g, n, ( i % 12 ) / 20.0, i+1 );
+    gs.push_back( g );
+    for ( uint32_t v = 0; v < n; v++ )
+      off.push_back( adj.size() + g->off[v] );
+    adj.insert( adj.end(), g->adj, g->adj + g->off[n] );
+    first.push_back( first.back() + n );
+  }
+  off.push_back( adj.size() );
+
+  GraphBatch b;
+  b.graphs = gs.size();
+  b.first  = &first[0];
+  b.off    = &off[0];
+  b.adj    = &adj[0];
+
+  for ( int e = PLUS; e < NUM_ENGINES; e++ )
+    for ( unsigned int th = 1; th <= 3; th += 2 ) {
+      Options opt;
+      opt.threads = th;
+      opt.seed    = 4;
+      opt.dd      = 0.3;
+      vector<Color> c( first.back() + 1 ), k( gs.size() );
+      BatchStats st;
+      size_t done = color_batch( b, Engine(e), opt, &c[0], &k[0], &st );
+      CHECK( done == gs.size() && st.failed == 0 && st.graphs == gs.size() );
+      CHECK( st.vertices == first.back() );
+
+      Options o1 = opt;
+      o1.threads = 1;
+      for ( size_t i = 0; i < gs.size(); i++ ) {
+	vector<Color> r;
+	Color kr = color( *gs[i], Engine(e), o1, r );
+	bool same = ( kr == k[i] );
+	for ( uint32_t v = 0; v < gs[i]->n && same; v++ )
+	  same = ( r[v] == c[first[i]+v] );
+	CHECK( same );
+      }
+    }
+
+  for ( size_t i = 0; i < gs.size(); i++ )
+    delete gs[i];
+  return check_result( "test_batch" );
+}
@@ -0,0 +1,160 @@
+/*
+ *  The layouts of the RLF engines give the same colorings as the structure
+ *  of arrays layout, at any thread count and SIMD level (run under RLF_SIMD),
+ *  so does the speculative pipeline, and self loops do not change a coloring.
+ */
+
+#include "rlf_soa.hpp"
+#include "rlf_complement.hpp"
+#include "rlf_compressed.hpp"
+#include "rlf_hybrid.hpp"
+#include "rlf_parallel.hpp"
+#include "rlf_small.hpp"
+#include "rlf_simd.hpp"
+
+#include "check.hpp"
+
+using namespace rlf;
+
+/// Every layout against SoALayout, for one engine (Selection, DegreeToU)
+template <class S, class D>
+static void check_layouts ( const CsrGraph& g, const Options& opt ) {
+  vector<Color> a, b;
+  Color ka = RlfEngine< S, D, SoALayout, uint32_t >::color( g, opt, a );
+  CHECK( valid_coloring( g, a, ka ) );
+
+  Color kl = RlfEngine< S, D, LinkedLayout, uint32_t >::color( g, opt, b );
+  CHECK( kl == ka && b == a );
+
+  if ( ComplementLayout<uint32_t>::fits( g ) ) {
+    Color kb = RlfEngine< S, D, ComplementLayout, uint32_t >::color( g, opt, b );
+    CHECK( kb == ka && b == a );
+  }
+  Color kc = RlfEngine< S, D, CompressedLayout, uint32_t >::color( g, opt, b );
+  CHECK( kc == ka && b == a );
+  Color kh = RlfEngine< S, D, HybridLayout, uint32_t >::color( g, opt, b );
+  CHECK( kh == ka && b == a );
+
+  Options o = opt;
+  o.threads = 3;
+  Color kp = RlfEngine< S, D, ParallelSoALayout, uint32_t >::color( g, o, b );
+  CHECK( kp == ka && b == a );
+
+  if ( g.n <= SMALL_MAX ) {
+    Color ks = color_small< S, D >( g, opt, b );
+    CHECK( ks == ka && b == a );
+  }
+}
+
+static void check_engines ( const CsrGraph& g, const Options& opt ) {
+  check_layouts< StaticSelection,  CountedU >( g, opt );   /// plus
+  check_layouts< StaticSelection,  ScannedU >( g, opt );   /// lazy
+  check_layouts< DensitySelection, CountedU >( g, opt );   /// adaptive
+}
+
+/// The public entry point with 1 and 3 threads
+static void check_threads ( const CsrGraph& g ) {
+  Engine engines[] = { PLUS, ADAPTIVE, JP };
+  for ( int e = 0; e < 3; e++ ) {
+    Options o1, o3;
+    o3.threads = 3;
+    vector<Color> a, b;
+    Color ka = color( g, engines[e], o1, a );
+    Color kb = color( g, engines[e], o3, b );
+    CHECK( valid_coloring( g, a, ka ) );
+    CHECK( ka == kb && a == b );
+  }
+}
+
+/// Classes built ahead by color_speculative, over all the graphs checked
+static size_t spec_tried = 0, spec_adopted = 0;
+
+/// color_speculative gives the coloring of PLUS, classes built ahead or not
+static void check_speculative ( const CsrGraph& g, const Options& opt ) {
+  Options o = opt;
+  o.cutoff = 0;
+  vector<Color>  a, b;
+  SpeculateStats st;
+  Color ka = color( g, PLUS, o, a );
+  Color kb = color_speculative( g, o, b, &st );
+  CHECK( ka == kb && a == b );
+  spec_tried   += st.tried;
+  spec_adopted += st.adopted;
+}
+
+/// A self loop (path 0-1-2, loop on 1) is ignored by every engine, and the
+/// small engine colors raw arrays with loops as without them
+static void check_self_loops ( void ) {
+  uint64_t off[4]  = { 0, 1, 4, 5 };
+  uint32_t adj[5]  = { 1, 0, 1, 2, 1 };
+  CsrGraph g;
+  CHECK( graph_from_csr( g, 3, off, adj ) );
+  CHECK( g.m == 2 );
+  for ( int e = 0; e < NUM_ENGINES; e++ ) {
+    vector<Color> c;
+    Color k = color( g, Engine(e), Options(), c );
+    CHECK( k == 2 && valid_coloring( g, c, k ) );
+  }
+
+  for ( unsigned int t = 0; t < 20; t++ ) {
+    CsrGraph h;
+    random_graph( h, 10 + 20*t, 0.3, t+1 );
+    /// The same lists with a loop on every third vertex
+    vector<uint64_t> lo( 1, 0 );
+    vector<uint32_t> la;
+    for ( uint32_t v = 0; v < h.n; v++ ) {
+      if ( v % 3 == 0 )
+	la.push_back( v );
+      la.insert( la.end(), h.adj + h.off[v], h.adj + h.off[v+1] );
+      lo.push_back( la.size() );
+    }
+    Options opt;
+    vector<Color> a( h.n ), b( h.n );
+    Color ka = color_small< StaticSelection, CountedU >( h.n, h.off, h.adj, opt, &a[0] );
+    Color kb = color_small< StaticSelection, CountedU >( h.n, &lo[0], &la[0], opt, &b[0] );
+    CHECK( ka > 0 && ka == kb && a == b );
+  }
+}
+
+int main ( void ) {
+  printf( "SIMD level: %s\n", simd::level_name( simd::level() ) );
+
+  /// Small and medium graphs of every density, some runs cut by a color cutoff
+  for ( unsigned int t = 0; t < 200; t++ ) {
+    uint32_t n = ( t % 3 == 0 ) ? 1 + t % 70 : 1 + ( t * 37 ) % 700;
+    double   p = ( t % 20 ) / 20.0;
+    CsrGraph g;
+    random_graph( g, n, p, t+1 );
+    Options opt;
+    opt.seed = 1 + t % 7;
+    opt.dd   = ( t % 10 ) / 10.0;
+    if ( t % 11 == 0 )
+      opt.cutoff = 3;
+    check_engines( g, opt );
+    check_speculative( g, opt );
+  }
+
+  /// A graph whose steps reach PARALLEL_MIN_WORK, so that the threads share them
+  {
+    CsrGraph g;
+    random_graph( g, 2000, 0.2, 100 );
+    check_engines( g, Options() );
+    check_threads( g );
+    check_speculative( g, Options() );
+  }
+
+  check_self_loops();
+  /// Both outcomes of the validation were taken
+  CHECK( spec_adopted > 0 && spec_tried > spec_adopted );
+
+  /// A run that fails leaves the colors alone, also through a relabeling
+  {
+    CsrGraph g;
+    random_graph( g, 50, 0.3, 7 );
+    Options o;
+    o.order = ORDER_DEGREE;
+    vector<Color> c( 3, 9 );
+    CHECK( color( g, NUM_ENGINES, o, c ) == 0 && c == vector<Color>( 3, 9 ) );
+  }
+  return check_result( "test_layouts" );
+}
@@ -0,0 +1,234 @@
+/*
+ *  The graph files: every format gives back the graph it was written from
+ *  (directly and through the converter), and corrupted .csr files (bad
+ *  sizes, offsets or neighbor lists) or edge lists are rejected instead of
+ *  being used.
+ *
+ *    test_loaders [converter]
+ */
+
+#include <cstring>
+#include <string>
+using std::string;
+
+#include <unistd.h>
+
+#include "graph_io.hpp"
+#include "check.hpp"
+
+static string dir;
+
+static string path ( const char* name ) {
+  return dir + "/" + name;
+}
+
+static bool same_graph ( const CsrGraph& a, const CsrGraph& b ) {
+  if ( a.n != b.n || a.m != b.m )
+    return false;
+  for ( uint32_t v = 0; v <= a.n; v++ )
+    if ( a.off[v] != b.off[v] )
+      return false;
+  return a.n == 0 || memcmp( a.adj, b.adj, a.off[a.n] * sizeof(uint32_t) ) == 0;
+}
+
+/// Load a file of any format as the converter does
+static bool load ( const string& name, GraphFormat f, CsrGraph& g ) {
+  if ( f == FMT_CSR )
+    return read_csr_bin( g, name.c_str(), true );
+  uint32_t    n = 0;
+  CsrEdgeList edges;
+  if ( !read_edges( name.c_str(), f, n, edges ) )
+    return false;
+  csr_from_edges( g, n, edges );
+  return true;
+}
+
+/// Overwrite 'len' bytes of a file at 'at'
+static void poke ( const string& name, long at, const void* data, size_t len ) {
+  FILE* f = fopen( name.c_str(), "r+b" );
+  CHECK( f != NULL );
+  if ( f == NULL )
+    return;
+  fseek( f, at, SEEK_SET );
+  CHECK( fwrite( data, 1, len, f ) == len );
+  fclose( f );
+}
+
+static void write_text ( const string& name, const char* text ) {
+  FILE* f = fopen( name.c_str(), "w" );
+  CHECK( f != NULL );
+  if ( f == NULL )
+    return;
+  fputs( text, f );
+  fclose( f );
+}
+
+/// Every format, written and read back
+static void check_formats ( const CsrGraph& g ) {
+  GraphFormat formats[] = { FMT_COL, FMT_ORLIB, FMT_EDGES, FMT_BIN, FMT_CSR };
+  for ( int i = 0; i < 5; i++ ) {
+    string name = path( "g" ) + format_extension( formats[i] );
+    CHECK( write_graph( g, name.c_str(), formats[i] ) );
+    CsrGraph h;
+    CHECK( load( name, formats[i], h ) && same_graph( g, h ) );
+  }
+  string raw = path( "raw.csr" );
+  CHECK( write_csr_bin( g, raw.c_str(), false ) );
+  CsrGraph h;
+  CHECK( read_graph( h, raw.c_str() ) && same_graph( g, h ) );
+}
+
+/// raw.csr -> .edges -> .col -> .orlib -> .b -> .csr with the converter
+static void check_converter ( const char* converter, const CsrGraph& g ) {
+  const char* chain[] = { "raw.csr", "c.el", "c.col", "c.orlib", "c.b", "c.csr" };
+  for ( int i = 0; i+1 < 6; i++ ) {
+    string cmd = string( converter ) + " " + path( chain[i] ) + " " + path( chain[i+1] ) + " > /dev/null";
+    CHECK( system( cmd.c_str() ) == 0 );
+  }
+  CsrGraph h;
+  CHECK( read_csr_bin( h, path( "c.csr" ).c_str(), true ) && same_graph( g, h ) );
+}
+
+/// A damaged copy of a .csr file must not load
+static void check_corrupt ( const CsrGraph& g, bool varint ) {
+  string   name = path( "bad.csr" );
+  uint64_t big  = uint64_t(1) << 40;
+  uint64_t v;
+  CsrGraph h;
+  for ( int damage = 0; damage < 6; damage++ ) {
+    CHECK( write_csr_bin( g, name.c_str(), varint ) );
+    switch ( damage ) {
+    case 0:   /// Truncated
+      CHECK( truncate( name.c_str(), 64 + 8*g.n ) == 0 );
+      break;
+    case 1:   /// n beyond the offsets
+      v = uint64_t(g.n) * 4;
+      poke( name, 16, &v, 8 );
+      break;
+    case 2:   /// m beyond the neighbor section
+      poke( name, 24, &big, 8 );
+      break;
+    case 3:   /// adjBytes beyond the file
+      poke( name, 32, &big, 8 );
+      break;
+    case 4:   /// Decreasing offsets
+      poke( name, 64 + 8*(g.n/2), &big, 8 );
+      break;
+    case 5: { /// Neighbor out of range (raw), unterminated varint
+      long at = 64 + 8*(g.n+1);
+      if ( varint ) {
+	unsigned char b[8];
+	memset( b, 0xFF, sizeof(b) );
+	poke( name, at, b, sizeof(b) );
+      } else {
+	uint32_t w = g.n;
+	poke( name, at, &w, 4 );
+      }
+      break;
+    }
+    }
+    CHECK( !read_csr_bin( h, name.c_str(), false ) );
+    CHECK( h.n == 0 && h.m == 0 );
+  }
+}
+
+/// Edge lists keep their declared n and reject ids out of it, or too large
+static void check_edge_lists ( void ) {
+  uint32_t    n;
+  CsrEdgeList edges;   /// Reused: every read starts from an empty list
+  write_text( path( "a.el" ), "# 6 2\n0 1\n1 2\n" );
+  CHECK( read_edges( path( "a.el" ).c_str(), FMT_EDGES, n, edges ) && n == 6 && edges.size() == 2 );
+  write_text( path( "b.el" ), "0 1\n1 5\n" );
+  CHECK( read_edges( path( "b.el" ).c_str(), FMT_EDGES, n, edges ) && n == 6 );
+  write_text( path( "c.el" ), "# 3 1\n0 5\n" );
+  CHECK( !read_edges( path( "c.el" ).c_str(), FMT_EDGES, n, edges ) );
+  write_text( path( "d.el" ), "0 99999999999999999999999\n" );
+  CHECK( !read_edges( path( "d.el" ).c_str(), FMT_EDGES, n, edges ) );
+  write_text( path( "e.el" ), "0 4294967296\n" );
+  CHECK( !read_edges( path( "e.el" ).c_str(), FMT_EDGES, n, edges ) );
+}
+
+/// Headers: n must fit in 32 bits, m only sizes a reservation, and the .b
+/// problem line is the one at the start of a line
+static void check_headers ( void ) {
+  uint32_t    n;
+  CsrEdgeList edges;
+  write_text( path( "a.col" ), "p edge 4294967298 1\ne 1 2\n" );
+  CHECK( !read_edges( path( "a.col" ).c_str(), FMT_COL, n, edges ) );
+  write_text( path( "b.col" ), "p edge 3 99999999999999\ne 1 2\n" );
+  CHECK( read_edges( path( "b.col" ).c_str(), FMT_COL, n, edges ) && n == 3 && edges.size() == 1 );
+  write_text( path( "a.orlib" ), "4294967298 1 0\n2\n1\n" );
+  CHECK( !read_edges( path( "a.orlib" ).c_str(), FMT_ORLIB, n, edges ) );
+  write_text( path( "b.orlib" ), "3 99999999999999 0\n2\n1\n\n" );
+  CHECK( read_edges( path( "b.orlib" ).c_str(), FMT_ORLIB, n, edges ) && n == 3 && edges.size() == 1 );
+  /// Rows of 1 byte: only the bit of (1, 0) is an edge
+  write_text( path( "a.b" ), "19\nc p 9 9\np edge 3 1\n\x01\x81\x01" );
+  CHECK( read_edges( path( "a.b" ).c_str(), FMT_BIN, n, edges ) && n == 3 && edges.size() == 1 );
+  write_text( path( "b.b" ), "99999999999\np edge 3 1\n" );
+  CHECK( !read_edges( path( "b.b" ).c_str(), FMT_BIN, n, edges ) );
+}
+
+/// Lists given as strings ("1 2|0|0" for vertex 0 next to 1 and 2), written
+/// raw and varint coded: the loader must reject both files
+static void check_bad_lists ( const char* lists ) {
+  CsrGraph g;
+  g.offsets.push_back( 0 );
+  const char* c = lists;
+  while ( *c != 0 ) {
+    char* end;
+    uint32_t w = uint32_t( strtoul( c, &end, 10 ) );
+    if ( end != c )
+      g.neighbors.push_back( w );
+    if ( *end == '|' )
+      g.offsets.push_back( g.neighbors.size() );
+    c = ( *end == 0 ) ? end : end+1;
+  }
+  g.offsets.push_back( g.neighbors.size() );
+  g.n = uint32_t( g.offsets.size() - 1 );
+  g.m = g.neighbors.size() / 2;
+  g.attach();
+  for ( int varint = 0; varint <= 1; varint++ ) {
+    string name = path( "bad.csr" );
+    CHECK( write_csr_bin( g, name.c_str(), varint != 0 ) );
+    CsrGraph h;
+    CHECK( !read_csr_bin( h, name.c_str(), true ) );
+    CHECK( h.n == 0 && h.m == 0 );
+  }
+}
+
+int main ( int argc, char* argv[] ) {
+  char tmpl[] = "/tmp/rlf_check_XXXXXX";
+  if ( mkdtemp( tmpl ) == NULL ) {
+    perror( "test_loaders" );
+    return EXIT_FAILURE;
+  }
+  dir = tmpl;
+
+  /// Isolated vertices at the end must survive every format
+  CsrEdgeList es;
+  for ( uint32_t a = 0; a < 300; a++ )
+    for ( uint32_t b = a+1; b < 300; b++ )
+      if ( ( a*31 + b*17 ) % 23 == 0 )
+	es.push_back( CsrEdge( a, b ) );
+  CsrGraph h;
+  csr_from_edges( h, 310, es );
+
+  check_formats( h );
+  if ( argc > 1 )
+    check_converter( argv[1], h );
+
+  check_corrupt( h, false );
+  check_corrupt( h, true );
+  /// Self loop, duplicate, unsorted list, edge listed from one end only
+  check_bad_lists( "0 1|0 1" );
+  check_bad_lists( "1 1|0 0" );
+  check_bad_lists( "2 1|0|0" );
+  check_bad_lists( "1 2|2|1" );
+  check_edge_lists();
+  check_headers();
+
+  string cmd = "rm -rf " + dir;
+  if ( system( cmd.c_str() ) != 0 )
+    perror( "test_loaders" );
+  return check_result( "test_loaders" );
+}
@@ -0,0 +1,104 @@
+/*
+ *  rlf::recolor returns a valid coloring of the changed graph, whatever the
+ *  tolerance, never worse than the local repair, and rejects vertices out of
+ *  range.
+ */
+
+#include <algorithm>
+using std::binary_search;
+using std::min;
+using std::max;
+
+#include <set>
+using std::set;
+
+#include "check.hpp"
+
+using namespace rlf;
+
+/// Edges of g changed by the delta
+static void apply_delta ( const CsrGraph& g, const EdgeDelta& d, CsrGraph& h ) {
+  set<CsrEdge> removed;
+  for ( size_t i = 0; i < d.removed.size(); i++ ) {
+    removed.insert( d.removed[i] );
+    removed.insert( CsrEdge( d.removed[i].second, d.removed[i].first ) );
+  }
+  CsrEdgeList es( d.added );
+  for ( uint32_t v = 0; v < g.n; v++ )
+    for ( uint64_t p = g.off[v]; p < g.off[v+1]; p++ )
+      if ( v < g.adj[p] && removed.count( CsrEdge( v, g.adj[p] ) ) == 0 )
+	es.push_back( CsrEdge( v, g.adj[p] ) );
+  csr_from_edges( h, g.n, es );
+}
+
+int main ( void ) {
+  for ( unsigned int t = 0; t < 60; t++ ) {
+    uint32_t n = 50 + ( t * 97 ) % 1500;
+    CsrGraph g;
+    random_graph( g, n, 0.02 + ( t % 5 ) / 20.0, t+1 );
+    vector<Color> colors;
+    Color k0 = color( g, PLUS, Options(), colors );
+    CHECK( valid_coloring( g, colors, k0 ) );
+
+    /// Edges inside color classes (conflicts) and other new edges, then removed edges
+    Random    rng( t+7 );
+    EdgeDelta d;
+    set<CsrEdge> added;
+    for ( unsigned int i = 0; i < 5 + t; i++ ) {
+      uint32_t a = rng() % n, b = rng() % n;
+      if ( i % 2 == 0 )
+	/// The next vertex of the color of a
+	for ( uint32_t j = 1; j < n; j++ )
+	  if ( colors[(a+j) % n] == colors[a] ) {
+	    b = (a+j) % n;
+	    break;
+	  }
+      CsrEdge e( min( a, b ), max( a, b ) );
+      if ( a == b || added.count( e ) > 0
+	   || binary_search( g.adj + g.off[a], g.adj + g.off[a+1], b ) )
+	continue;
+      added.insert( e );
+      d.added.push_back( e );
+    }
+    for ( uint32_t v = 0; v < n; v += 1 + rng() % 40 )
+      if ( g.degree( v ) > 0 ) {
+	uint32_t w = g.adj[g.off[v] + rng() % g.degree( v )];
+	if ( added.count( CsrEdge( min( v, w ), max( v, w ) ) ) == 0 )
+	  d.removed.push_back( CsrEdge( v, w ) );
+      }
+
+    CsrGraph h;
+    apply_delta( g, d, h );
+    /// The repair alone, never replaced by a full run
+    RecolorOptions lo;
+    lo.tolerance = h.n;
+    vector<Color> cl( colors );
+    Color kl = recolor( g, d, lo, cl, NULL );
+    CHECK( valid_coloring( h, cl, kl ) );
+    for ( unsigned int tol = 0; tol <= 4; tol += 2 ) {
+      RecolorOptions ro;
+      ro.tolerance = tol;
+      vector<Color> c( colors );
+      RecolorStats st;
+      Color k = recolor( g, d, ro, c, &st );
+      CHECK( valid_coloring( h, c, k ) );
+      if ( !st.full )
+	CHECK( k <= k0 + st.local );
+      CHECK( k <= kl );
+    }
+  }
+
+  /// Out of range vertices are rejected
+  CsrGraph g;
+  random_graph( g, 20, 0.3, 1 );
+  vector<Color> c;
+  color( g, PLUS, Options(), c );
+  EdgeDelta d;
+  d.added.push_back( CsrEdge( 3, 20 ) );
+  CHECK( recolor( g, d, RecolorOptions(), c, NULL ) == 0 );
+  d.added.clear();
+  d.removed.push_back( CsrEdge( 25, 1 ) );
+  CHECK( recolor( g, d, RecolorOptions(), c, NULL ) == 0 );
+
+  return check_result( "test_recolor" );
+}